@@ -0,0 +1,464 @@
+// ECS̃x`}[N
+// Entity̐ƂɊeP[XvA1Entitỹimbp[Z^CƂƂJSONŏo͂
+// łΓs(--seedŌŒ)̂ŁA[XƂ̌ʂrĐ\̗򉻂mFł
+//
+// rh
+//   Windows : EntityComponentSystem.slnBenchmarkvWFNg
+//   Linux   : cmake -S . -B build && cmake --build build -j --target ecs_benchmark
+//             \[XCP932Ȃ̂GCCł-finput-charset=CP932Kv(CMakeLists.txtŎw肵Ă)
+//             DirectXMathȂꍇECS_NO_DIRECTXMATH`ărh
+//
+// g
+//   ecs_benchmark [--timer chrono|rdtsc] [--min-entities N] [--max-entities N] [--repeat N] [--seed N] [--filter ] [--out pX]
+//   --timer        vɎgp^C}[(chrono) rdtscx86̂
+//   --min-entities vEntity̐̍ŏ(1000) 100010{₷
+//   --max-entities vEntity̐̍ő(10000000)
+//   --repeat       eP[X̌JԂ(5)
+//   --filter       Oɂ̕܂ރP[Xv
+//   --out          JSON̏o͐(͕Wo) i͕WG[o͂ɏo͂
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+#include "World.h"
+#include "System.h"
+#include "BenchmarkTimer.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace
+{
+	struct Position
+	{
+		float3 value_;
+	};
+
+	struct Velocity
+	{
+		float3 value_;
+	};
+
+	// Archetype̐𑝂₷߂̃^O rbg̑gݍ킹ōő256ނArchetype
+	template<u32 kBit>
+	struct ScaleTag {};
+
+	constexpr u32 kScaleTagCounts{ 8 };
+
+	// 1̃TvŌv鑀̐ 1񂸂̑(AddEntityȂ)͂̐Ƃɂ܂Ƃ߂Čv
+	constexpr u32 kBatchSize{ 1000 };
+
+	// Foreacȟv1̃Tv܂łɑŏEntity̐
+	// Entity̐Ȃꍇ̓^C}[̕\ɖȂ悤ɉxĂ畽ς
+	constexpr u64 kMinForeachEntitiesPerSample{ 1'000'000 };
+
+	// œKŌvZ菜Ȃ悤Ɍʂ
+	volatile float g_sink{};
+
+	class OffsetSystem : public ecs::BaseSystem
+	{
+	public:
+		void Execute() override
+		{
+			Foreach([](Position& position)
+			{
+				position.value_.x += 1.0f;
+				position.value_.y += 1.0f;
+				position.value_.z += 1.0f;
+			});
+		}
+	};
+
+	class MoveSystem : public ecs::BaseSystem
+	{
+	public:
+		void Execute() override
+		{
+			Foreach([](Position& position, const Velocity& velocity)
+			{
+				position.value_.x += velocity.value_.x;
+				position.value_.y += velocity.value_.y;
+				position.value_.z += velocity.value_.z;
+			});
+		}
+	};
+
+	struct Options
+	{
+		BenchmarkTimer::Backend timer_{ BenchmarkTimer::Backend::kChrono };
+		u64 min_entities_{ 1'000 };
+		u64 max_entities_{ 10'000'000 };
+		u32 repeat_{ 5 };
+		u64 seed_{ 1 };
+		String filter_{};
+		String out_{};
+	};
+
+	// Tv(1Entitỹimb)̓v
+	struct Statistics
+	{
+		double min_;
+		double mean_;
+		double p50_;
+		double p90_;
+		double p99_;
+		double max_;
+	};
+
+	// 1̃P[XEntity̐̑gݍ킹̌
+	struct Result
+	{
+		String name_;
+		u64 entities_;
+		u32 archetypes_;
+		u64 sample_counts_;
+		Statistics statistics_;
+	};
+
+	// eP[XŌvTvW߂
+	class Samples
+	{
+	public:
+		explicit Samples(const BenchmarkTimer& timer) : timer_(&timer) {}
+
+		// [begin, end)̌vʂentity_counts̏ƂăTvɒǉ
+		void Add(u64 begin, u64 end, u64 entity_counts)
+		{
+			values_.emplace_back(timer_->ToNanoseconds(end - begin) / static_cast<double>(entity_counts));
+		}
+
+		const BenchmarkTimer& GetTimer() const { return *timer_; }
+
+		// p[Z^C͍ŋߖTʖ@ŋ߂
+		Statistics CreateStatistics()
+		{
+			std::ranges::sort(values_);
+			const auto percentile = [this](double p)
+			{
+				const u64 rank{ static_cast<u64>(std::ceil(p / 100.0 * static_cast<double>(values_.size()))) };
+				return values_[std::clamp<u64>(rank, 1, values_.size()) - 1];
+			};
+			const double sum{ std::accumulate(values_.begin(), values_.end(), 0.0) };
+			return { values_.front(), sum / static_cast<double>(values_.size()), percentile(50.0), percentile(90.0), percentile(99.0), values_.back() };
+		}
+
+		u64 GetCounts() const { return values_.size(); }
+
+	private:
+		const BenchmarkTimer* timer_;
+		Vector<double> values_{};
+	};
+
+	// eP[X̌v֐ void(Samples& samples, u64 entity_counts, const Options& options)
+	// World̍쐬Entity̏͌vɊ܂߂Ȃ
+	using CaseFunction = void(*)(Samples&, u64, const Options&);
+
+	Vector<u32> CreateShuffledIndices(u64 counts, u64 seed)
+	{
+		Vector<u32> indices(counts);
+		std::iota(indices.begin(), indices.end(), 0u);
+		std::mt19937_64 engine{ seed };
+		std::ranges::shuffle(indices, engine);
+		return indices;
+	}
+
+	void CreateBulk(Samples& samples, u64 entity_counts, const Options& options)
+	{
+		Vector<Entity> entities(entity_counts);
+		for(u32 i = 0; i < options.repeat_; ++i)
+		{
+			ecs::World world{ 0 };
+			const u64 begin{ samples.GetTimer().Now() };
+			world.AddEntities(static_cast<u32>(entity_counts), entities, Position{}, Velocity{});
+			samples.Add(begin, samples.GetTimer().Now(), entity_counts);
+		}
+	}
+
+	void DestroyBulk(Samples& samples, u64 entity_counts, const Options& options)
+	{
+		Vector<Entity> entities(entity_counts);
+		for(u32 i = 0; i < options.repeat_; ++i)
+		{
+			ecs::World world{ 0 };
+			world.AddEntities(static_cast<u32>(entity_counts), entities, Position{}, Velocity{});
+
+			const u64 begin{ samples.GetTimer().Now() };
+			world.RemoveEntities(entities);
+			samples.Add(begin, samples.GetTimer().Now(), entity_counts);
+		}
+	}
+
+	void AddSingle(Samples& samples, u64 entity_counts, const Options& options)
+	{
+		for(u32 i = 0; i < options.repeat_; ++i)
+		{
+			ecs::World world{ 0 };
+			for(u64 added = 0; added < entity_counts; added += kBatchSize)
+			{
+				const u64 counts{ std::min<u64>(kBatchSize, entity_counts - added) };
+				const u64 begin{ samples.GetTimer().Now() };
+				for(u64 j = 0; j < counts; ++j) (void)world.AddEntity(Position{}, Velocity{});
+				samples.Add(begin, samples.GetTimer().Now(), counts);
+			}
+		}
+	}
+
+	// 폜鏇Ԃ̓_ ̍s̈ړ܂
+	void RemoveSingle(Samples& samples, u64 entity_counts, const Options& options)
+	{
+		Vector<Entity> entities(entity_counts);
+		const Vector<u32> order{ CreateShuffledIndices(entity_counts, options.seed_) };
+		for(u32 i = 0; i < options.repeat_; ++i)
+		{
+			ecs::World world{ 0 };
+			world.AddEntities(static_cast<u32>(entity_counts), entities, Position{}, Velocity{});
+			for(u64 removed = 0; removed < entity_counts; removed += kBatchSize)
+			{
+				const u64 counts{ std::min<u64>(kBatchSize, entity_counts - removed) };
+				const u64 begin{ samples.GetTimer().Now() };
+				for(u64 j = removed; j < removed + counts; ++j) world.RemoveEntity(entities[order[j]]);
+				samples.Add(begin, samples.GetTimer().Now(), counts);
+			}
+		}
+	}
+
+	// SystemManagerʂSystems ŏ̎s͎s̍쐬܂ނ̂ŌvȂ
+	// 1̃TvōŒkMinForeachEntitiesPerSampleEntity𑖍
+	template<class System>
+	void MeasureForeach(Samples& samples, ecs::World& world, u64 entity_counts, const Options& options)
+	{
+		world.GetSystemManager()->AddSystems<System>();
+		world.GetSystemManager()->Execute();
+
+		const u64 passes{ std::max<u64>(kMinForeachEntitiesPerSample / entity_counts, 1) };
+		for(u32 i = 0; i < options.repeat_; ++i)
+		{
+			const u64 begin{ samples.GetTimer().Now() };
+			for(u64 j = 0; j < passes; ++j) world.GetSystemManager()->Execute();
+			samples.Add(begin, samples.GetTimer().Now(), entity_counts * passes);
+		}
+	}
+
+	template<class System>
+	void ForeachComponents(Samples& samples, u64 entity_counts, const Options& options)
+	{
+		ecs::World world{ 0 };
+		Vector<Entity> entities(entity_counts);
+		world.AddEntities(static_cast<u32>(entity_counts), entities, Position{}, Velocity{ float3{ 1.0f, 1.0f, 1.0f } });
+		MeasureForeach<System>(samples, world, entity_counts, options);
+	}
+
+	void GetRandom(Samples& samples, u64 entity_counts, const Options& options)
+	{
+		ecs::World world{ 0 };
+		Vector<Entity> entities(entity_counts);
+		world.AddEntities(static_cast<u32>(entity_counts), entities, Position{}, Velocity{});
+		const Vector<u32> order{ CreateShuffledIndices(entity_counts, options.seed_) };
+
+		float sum{};
+		for(u32 i = 0; i < options.repeat_; ++i)
+		{
+			for(u64 read = 0; read < entity_counts; read += kBatchSize)
+			{
+				const u64 counts{ std::min<u64>(kBatchSize, entity_counts - read) };
+				const u64 begin{ samples.GetTimer().Now() };
+				for(u64 j = read; j < read + counts; ++j) sum += world.GetComponentData<Position>(entities[order[j]]).value_.x;
+				samples.Add(begin, samples.GetTimer().Now(), counts);
+			}
+		}
+		g_sink = sum;
+	}
+
+	void SetRandom(Samples& samples, u64 entity_counts, const Options& options)
+	{
+		ecs::World world{ 0 };
+		Vector<Entity> entities(entity_counts);
+		world.AddEntities(static_cast<u32>(entity_counts), entities, Position{}, Velocity{});
+		const Vector<u32> order{ CreateShuffledIndices(entity_counts, options.seed_) };
+
+		for(u32 i = 0; i < options.repeat_; ++i)
+		{
+			for(u64 written = 0; written < entity_counts; written += kBatchSize)
+			{
+				const u64 counts{ std::min<u64>(kBatchSize, entity_counts - written) };
+				const u64 begin{ samples.GetTimer().Now() };
+				for(u64 j = written; j < written + counts; ++j)
+				{
+					const float value{ static_cast<float>(j) };
+					world.SetComponentData(entities[order[j]], Position{ float3{ value, value, value } });
+				}
+				samples.Add(begin, samples.GetTimer().Now(), counts);
+			}
+		}
+	}
+
+	// mask̃rbgɑΉScaleTagvnu쐬
+	template<u32 ...kBits>
+	Entity CreateScalePrefab(ecs::World& world, u32 mask, std::integer_sequence<u32, kBits...>)
+	{
+		const Entity prefab{ world.AddEntity(Position{}, Velocity{ float3{ 1.0f, 1.0f, 1.0f } }, ecs::Prefab{}) };
+		([&world, prefab, mask]
+		{
+			if(mask & 1u << kBits) world.AddComponent(prefab, ScaleTag<kBits>{});
+		}(), ...);
+		return prefab;
+	}
+
+	// Entity͓̑܂܁AArchetype̐𑝂₵Ƃ2ComponentForeach
+	template<u32 kArchetypeCounts>
+	void ForeachArchetypes(Samples& samples, u64 entity_counts, const Options& options)
+	{
+		static_assert(kArchetypeCounts <= 1u << kScaleTagCounts);
+
+		ecs::World world{ 0 };
+		Vector<Entity> entities(entity_counts);
+		u64 offset{};
+		for(u32 i = 0; i < kArchetypeCounts; ++i)
+		{
+			const u64 counts{ entity_counts / kArchetypeCounts + (i < entity_counts % kArchetypeCounts ? 1 : 0) };
+			const Entity prefab{ CreateScalePrefab(world, i, std::make_integer_sequence<u32, kScaleTagCounts>{}) };
+			world.Instantiate(prefab, static_cast<u32>(counts), std::span{ entities }.subspan(offset, counts));
+			offset += counts;
+		}
+		MeasureForeach<MoveSystem>(samples, world, entity_counts, options);
+	}
+
+	struct Case
+	{
+		const char* name_;
+		u32 archetypes_;		// Entityi[Archetype̐
+		u64 min_entities_;	// 菭ȂEntity̐ł͌vȂ(ArchetypeƂ1ȏEntityKvȏꍇȂ)
+		CaseFunction function_;
+	};
+
+	constexpr Case kCases[]
+	{
+		{ "create_bulk", 1, 0, &CreateBulk },
+		{ "destroy_bulk", 1, 0, &DestroyBulk },
+		{ "add_single", 1, 0, &AddSingle },
+		{ "remove_single", 1, 0, &RemoveSingle },
+		{ "foreach_1", 1, 0, &ForeachComponents<OffsetSystem> },
+		{ "foreach_2", 1, 0, &ForeachComponents<MoveSystem> },
+		{ "get_random", 1, 0, &GetRandom },
+		{ "set_random", 1, 0, &SetRandom },
+		{ "foreach_2_archetypes", 1, 1, &ForeachArchetypes<1> },
+		{ "foreach_2_archetypes", 16, 16, &ForeachArchetypes<16> },
+		{ "foreach_2_archetypes", 256, 256, &ForeachArchetypes<256> },
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for(int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg{ argv[i] };
+			if(i + 1 >= argc)
+			{
+				std::cerr << "lw肳Ă܂: " << arg << std::endl;
+				return false;
+			}
+
+			const std::string_view value{ argv[++i] };
+			if(arg == "--timer")
+			{
+				if(value == "chrono") options.timer_ = BenchmarkTimer::Backend::kChrono;
+				else if(value == "rdtsc") options.timer_ = BenchmarkTimer::Backend::kRdtsc;
+				else
+				{
+					std::cerr << "sȃ^C}[ł: " << value << std::endl;
+					return false;
+				}
+			}
+			else if(arg == "--min-entities") options.min_entities_ = std::strtoull(value.data(), nullptr, 10);
+			else if(arg == "--max-entities") options.max_entities_ = std::strtoull(value.data(), nullptr, 10);
+			else if(arg == "--repeat") options.repeat_ = static_cast<u32>(std::strtoul(value.data(), nullptr, 10));
+			else if(arg == "--seed") options.seed_ = std::strtoull(value.data(), nullptr, 10);
+			else if(arg == "--filter") options.filter_ = value;
+			else if(arg == "--out") options.out_ = value;
+			else
+			{
+				std::cerr << "sȃIvVł: " << arg << std::endl;
+				return false;
+			}
+		}
+
+		if(options.repeat_ == 0 || options.min_entities_ == 0 || options.max_entities_ > std::numeric_limits<u32>::max())
+		{
+			std::cerr << "--repeatA--min-entities1ȏA--max-entitiesu32͈̔͂Ŏw肵Ă" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	void WriteJson(std::ostream& out, const BenchmarkTimer& timer, const Options& options, const Vector<Result>& results)
+	{
+		out << std::setprecision(6) << std::fixed;
+		out << "{\n";
+		out << "  \"schema\": 1,\n";
+		out << "  \"timer\": \"" << timer.GetName() << "\",\n";
+		out << "  \"nanoseconds_per_count\": " << timer.GetNanosecondsPerCount() << ",\n";
+		out << "  \"repeat\": " << options.repeat_ << ",\n";
+		out << "  \"seed\": " << options.seed_ << ",\n";
+#ifdef NDEBUG
+		out << "  \"build\": \"release\",\n";
+#else
+		out << "  \"build\": \"debug\",\n";
+#endif
+		out << "  \"results\": [";
+		for(u64 i = 0; i < results.size(); ++i)
+		{
+			const Result& result{ results[i] };
+			const Statistics& statistics{ result.statistics_ };
+			out << (i == 0 ? "\n" : ",\n");
+			out << "    { \"name\": \"" << result.name_ << "\", \"entities\": " << result.entities_ << ", \"archetypes\": " << result.archetypes_
+				<< ", \"samples\": " << result.sample_counts_ << ", \"ns_per_entity\": { \"min\": " << statistics.min_ << ", \"mean\": " << statistics.mean_
+				<< ", \"p50\": " << statistics.p50_ << ", \"p90\": " << statistics.p90_ << ", \"p99\": " << statistics.p99_ << ", \"max\": " << statistics.max_ << " } }";
+		}
+		out << "\n  ]\n}\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options{};
+	if(!ParseOptions(argc, argv, options)) return 1;
+
+	if(options.timer_ == BenchmarkTimer::Backend::kRdtsc && !BenchmarkTimer::IsRdtscAvailable())
+	{
+		std::cerr << "rdtscgpłȂȂ̂chronoŌv܂" << std::endl;
+	}
+	const BenchmarkTimer timer{ options.timer_ };
+
+	Vector<Result> results{};
+	for(const Case& benchmark_case : kCases)
+	{
+		if(!options.filter_.empty() && std::string_view{ benchmark_case.name_ }.find(options.filter_) == std::string_view::npos) continue;
+
+		for(u64 entity_counts = options.min_entities_; entity_counts <= options.max_entities_; entity_counts *= 10)
+		{
+			if(entity_counts < benchmark_case.min_entities_) continue;
+
+			std::cerr << benchmark_case.name_ << " archetypes=" << benchmark_case.archetypes_ << " entities=" << entity_counts << std::endl;
+			Samples samples{ timer };
+			benchmark_case.function_(samples, entity_counts, options);
+			results.emplace_back(Result{ benchmark_case.name_, entity_counts, benchmark_case.archetypes_, samples.GetCounts(), samples.CreateStatistics() });
+		}
+	}
+
+	if(options.out_.empty())
+	{
+		WriteJson(std::cout, timer, options, results);
+	}
+	else
+	{
+		std::ofstream file{ options.out_ };
+		if(!file)
+		{
+			std::cerr << "o͐J܂: " << options.out_ << std::endl;
+			return 1;
+		}
+		WriteJson(file, timer, options, results);
+	}
+	return 0;
+}
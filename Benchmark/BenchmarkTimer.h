@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include "CommonHeader.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ECS_BENCHMARK_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ECS_BENCHMARK_HAS_RDTSC 1
+#else
+#define ECS_BENCHMARK_HAS_RDTSC 0
+#endif
+
+// x`}[ŇvɎgp^C}[
+// steady_clockrdtsc(x86̂)؂ւ ǂNow̍ToNanosecondsŃimbɊZ
+// rdtsc͌ĂяõRXĝŒZԂ𑽂vꍇɎgp
+// g͍쐬steady_clockƔrċ߂̂ŁATSC̎gŐiCPU(invariant TSC)łȂ΂ȂȂ
+class BenchmarkTimer
+{
+public:
+	enum class Backend
+	{
+		kChrono,
+		kRdtsc,
+	};
+
+	static constexpr bool IsRdtscAvailable() { return ECS_BENCHMARK_HAS_RDTSC != 0; }
+
+	// backend rdtscgpłȂkRdtscw肵ꍇkChronoɂȂ
+	explicit BenchmarkTimer(Backend backend) : backend_(IsRdtscAvailable() ? backend : Backend::kChrono)
+	{
+		if(backend_ == Backend::kRdtsc) Calibrate();
+	}
+
+	// ݂̃JEg Pʂ̓obNGhɂĈقȂ
+	u64 Now() const
+	{
+#if ECS_BENCHMARK_HAS_RDTSC
+		if(backend_ == Backend::kRdtsc) return __rdtsc();
+#endif
+		return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+	}
+
+	// Now̍imbɊZ
+	double ToNanoseconds(u64 counts) const { return static_cast<double>(counts) * nanoseconds_per_count_; }
+
+	Backend GetBackend() const { return backend_; }
+	const char* GetName() const { return backend_ == Backend::kRdtsc ? "rdtsc" : "chrono"; }
+	double GetNanosecondsPerCount() const { return nanoseconds_per_count_; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	// 莞ԂTSC̑ʂsteady_clockƔrāA1JEg̃imb߂
+	void Calibrate()
+	{
+		constexpr std::chrono::milliseconds kCalibrationTime{ 100 };
+
+		const Clock::time_point clock_begin{ Clock::now() };
+		const u64 begin{ Now() };
+		while(Clock::now() - clock_begin < kCalibrationTime) {}
+		const u64 end{ Now() };
+		const Clock::time_point clock_end{ Clock::now() };
+
+		const double elapsed{ std::chrono::duration<double, std::nano>(clock_end - clock_begin).count() };
+		nanoseconds_per_count_ = end > begin ? elapsed / static_cast<double>(end - begin) : 1.0;
+	}
+
+private:
+	Backend backend_;
+	double nanoseconds_per_count_{ 1.0 };	// kChronȍꍇNowimbȂ̂1
+};
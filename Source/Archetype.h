@@ -6,109 +6,121 @@
 struct Archetype
 {
 	friend class Chunk;
+	friend class ArchetypeStorage;
 
 public:
 
 	// VArchetype쐬
 	// ...Components	ComponentData ł
 	template<class ...Components>
-	constexpr static Archetype Create()
+	static Archetype Create()
 	{
-		Archetype archetype{};
-		archetype.archetype_id_ = StringToHash(CreateUUID());
-		CreateImpl<Components...>(archetype);
+		// ^̃R|[lg𕡐w肷邱Ƃ͂łȂ
+		static_assert(!IsArgsHasSameType<Components...>(), "R|[lgw肳Ă܂");
 
-		return archetype;
+		return Create(GetSortedComponentIds<Components...>());
 	}
 
-	bool operator==(const Archetype& other) const
+	// VArchetype쐬
+	// sComponent̑gݍ킹܂ꍇɎgp
+	// component_ids	ɕ񂾏d̂ȂComponentId
+	static Archetype Create(std::span<const ComponentId> component_ids)
 	{
-		if(other.component_ids_.size() != this->component_ids_.size()) return false;
+		_ASSERT_EXPR(std::ranges::is_sorted(component_ids), L"ComponentId͏ɕׂĂ");
+		_ASSERT_EXPR(std::ranges::adjacent_find(component_ids) == component_ids.end(), L"R|[lgw肳Ă܂");
 
-		// TODO unordered_set̓lZq͂ǂĂ̂mF
-		if(other.component_ids_ != this->component_ids_) return false;
+		Archetype archetype{};
+		archetype.archetype_id_ = CreateArchetypeId(component_ids);
+		archetype.component_ids_.assign(component_ids.begin(), component_ids.end());
+		for(const ComponentId id : component_ids)
+		{
+			archetype.size_ += ComponentTypeRegistry::GetSize(id);
+		}
 
-		return true;
+		return archetype;
 	}
 
-	// w肳ꂽComponentsێĂ邩
+	// Components̃VOl`(ɕׂComponentId)擾
+	// ^w肳ꂽꍇ1ɂ܂Ƃ߂(QueryœComponentƃtB^̗Ɏw肵ꍇȂ)
+	// ^̑gݍ킹ƂɈxvZăLbV
 	template<class ...Components>
-	bool Contains() const
+	static std::span<const ComponentId> GetSortedComponentIds()
 	{
-		return ContainsImpl<Components...>();
+		struct SortedIds
+		{
+			std::array<ComponentId, sizeof...(Components)> ids_;
+			u64 counts_;
+		};
+		static const SortedIds sorted_ids{ []
+		{
+			SortedIds ret{ { GET_COMPONENT_ID(Components)... }, 0 };
+			std::ranges::sort(ret.ids_);
+			ret.counts_ = static_cast<u64>(std::ranges::unique(ret.ids_).begin() - ret.ids_.begin());
+			return ret;
+		}() };
+		return std::span<const ComponentId>{ sorted_ids.ids_.data(), sorted_ids.counts_ };
 	}
 
+	// Components̑gݍ킹ArchetypeID쐬
+	// ^̑gݍ킹ƂɈxvZăLbV
+	template<class ...Components>
+	static ArchetypeId CreateArchetypeId()
+	{
+		static const ArchetypeId id{ CreateArchetypeId(GetSortedComponentIds<Components...>()) };
+		return id;
+	}
 
-
-	ArchetypeId GetArchetypeId() const { return archetype_id_; }
-
-private:
-
-	// Archetype쐬֐̎
-	// ϒpēnꂽSR|[lgIDATCYAOi[
-	// Head				ϒ̐擪̃f[^
-	// ...Components	c̉ϒf[^
-	template<class Head, class ...Components>
-	static void CreateImpl(Archetype& archetype)
+	// VOl`ArchetypeID쐬
+	// Component̑gݍ킹łΎs邽тɓlɂȂ(FNV-1a)
+	// component_ids	ɕ񂾏d̂ȂComponentId
+	static ArchetypeId CreateArchetypeId(std::span<const ComponentId> component_ids)
 	{
-		const u32 size{ static_cast<u32>(sizeof(Head)) };
-		const ComponentId id{ GET_COMPONENT_ID(Head) };
-		const String name{ GET_COMPONENT_NAME(Head) };
-
-		// id邱Ƃ͂肦Ȃ̂ŃAT[g
-		// ̃AT[gs遨^̃R|[lg𕡐gpĂ(ϒɓ^̃R|[lg܂܂)
-#ifdef _DEBUG
-		for(const auto& val : archetype.component_name_ | std::views::values)
+		ArchetypeId hash{ 14695981039346656037ull };
+		for(const ComponentId id : component_ids)
 		{
-			_ASSERT_EXPR(val != name, L"R|[lgw肳Ă܂");
+			for(u32 i = 0; i < sizeof(ComponentId); ++i)
+			{
+				hash ^= (id >> (i * 8)) & 0xff;
+				hash *= 1099511628211ull;
+			}
 		}
-#endif
-
-		// ̃AT[goɂ̃AT[goꍇhash_code@\삷Kv
-		_ASSERT_EXPR(!archetype.component_ids_.contains(id), L"typeid::hash_code()lo͂܂");
+		return hash;
+	}
 
-		archetype.component_ids_.insert(id);
-		archetype.component_size_.insert({ id, size });
-		archetype.component_name_.insert({ id, name });
-		archetype.size_ += size;
+	bool operator==(const Archetype& other) const
+	{
+		return other.component_ids_ == this->component_ids_;
+	}
 
-		// ܂ϒꍇ͓eĂяo
-		if constexpr(sizeof...(Components) != 0)
-		{
-			CreateImpl<Components...>(archetype);
-		}
+	// VOl`SɈvĂ邩
+	// component_ids	ɕ񂾏d̂ȂComponentId
+	bool IsSame(std::span<const ComponentId> component_ids) const
+	{
+		return std::ranges::equal(component_ids_, component_ids);
 	}
 
-	// w肳ꂽR|[lgێĂ邩mF
-	template<class Head, class ...Tails>
-	bool ContainsImpl() const
+	// w肳ꂽComponentsێĂ邩
+	template<class ...Components>
+	bool Contains() const
 	{
-		// ^񂩂nbVR[hoAێĂ邩mF
-		const ComponentId id{ GET_COMPONENT_ID(Head) };
-		if(component_ids_.contains(id))
-		{
-			// ێĂꍇ́Aw肳ꂽComponents̐ɂď킯
-			// ɂw肳ꂽR|[lgȂ瓯JԂ
-			// ȂȂtrueԂ
-			if constexpr(sizeof...(Tails) != 0)
-			{
-				return ContainsImpl<Tails...>();
-			}
-			return true;
-		}
+		return (Contains(GET_COMPONENT_ID(Components)) && ...);
+	}
 
-		// ێĂȂꍇ̂ݒʂ
-		return false;
+	// w肳ꂽComponentIdێĂ邩
+	// component_ids_͏ɕł̂œ񕪒TŊmF
+	bool Contains(ComponentId id) const
+	{
+		return std::ranges::binary_search(component_ids_, id);
 	}
 
-private:
+	ArchetypeId GetArchetypeId() const { return archetype_id_; }
+	std::span<const ComponentId> GetComponentIds() const { return component_ids_; }
+	u32 GetSize() const { return size_; }
 
-	ArchetypeId archetype_id_;
-	UnorderedSet<ComponentId> component_ids_;
-	UnorderedMap<ComponentId, u32> component_size_;
-	UnorderedMap<ComponentId, String> component_name_;
-	
-	u32 size_;	//ێĂR|[lg̃f[^TCY̍v
-};
+private:
 
+	ArchetypeId archetype_id_{};
+	Vector<ComponentId> component_ids_{};	// ɕComponentId ArchetypẽVOl`
 
+	u32 size_{};	//ێĂR|[lg̃f[^TCY̍v
+};
@@ -0,0 +1,393 @@
+#pragma once
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+#include "Archetype.h"
+#include "Entity.h"
+#include "Chunk.h"
+
+// ArchetypeStoragẽ̎gp World::GetMemoryStatsŎ擾
+struct ArchetypeMemoryStats
+{
+	const ArchetypeStorage* storage_{};
+	u32 entity_counts_{};
+	u32 capacity_{};			// SChunkɊi[łEntity̐
+	u32 chunk_counts_{};
+	u64 used_bytes_{};			// EntityێĂs̃TCY(Entity̗܂)̍v
+	u64 allocated_bytes_{};		// Chunkmۂ̈̃TCY̍v
+	u64 overhead_bytes_{};		// Chunk̊Ǘp̃f[^(Chunk̂Ɨ̏AChunk̕\)̃TCY
+	u64 entity_map_bytes_{};	// EntityManager̕\̂AArchetypeStorageEntitẙi[ꏊgpĂTCY
+};
+
+// 1ArchetypeɑEntityێRei
+// ŒTCYChunk̃XgLAeʂȂȂChunkǉ
+// Entity͏ɑOChunkl߂Ċi[(ChunkȊO͖t)
+// EntityێĂȂꍇChunk1cĂAShrinkToFitĂ񂾂Ƃ
+// LComponentArchetype͋LComponent̒l̑gƂɕʁXArchetypeStorageɂȂ
+class ArchetypeStorage
+{
+public:
+	// archetype ێEntityArchetype
+	// memory_resource Chunk̃̊mۂɎgp郁\[X ArchetypeStorage蒷ĂȂ΂ȂȂ
+	// change_version World̕ύXo[W ArchetypeStorage蒷ĂȂ΂ȂȂ
+	// shared_values SChunkŋʂ̋LComponent̒l ComponentId̏ɕсAArchetype̋LComponentׂĊ܂
+	ArchetypeStorage(Archetype archetype, std::pmr::memory_resource& memory_resource, const u32& change_version, Vector<SharedComponentValue> shared_values)
+		: archetype_(std::move(archetype)), memory_resource_(&memory_resource), change_version_(&change_version), shared_values_(std::move(shared_values))
+	{
+		chunk_capacity_ = Chunk::CalculateCapacity(archetype_);
+
+		AddChunk();
+		layout_ = chunks_.front()->GetLayout();
+	}
+	~ArchetypeStorage() = default;
+
+	// ChunkێĂArchetypeQƂĂ̂ňړRs[s
+	ArchetypeStorage(const ArchetypeStorage&) = delete;
+	ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+	ArchetypeStorage(ArchetypeStorage&&) = delete;
+	ArchetypeStorage& operator=(ArchetypeStorage&&) = delete;
+
+	// SComponentsێĂ邩
+	//  <Transform, Camera, Light> : ێ<Transform, Camera, Light, Mesh> ̏ꍇfalseԂ
+	// ɈvĂƂtrueԂ
+	template<class ...Components>
+	bool IsSame() const
+	{
+		return archetype_.IsSame(Archetype::GetSortedComponentIds<Components...>());
+	}
+
+	// w肳ꂽComponentׂĕێĂ邩ǂ
+	// ێĂ邯EntityȂ or łێĂȂꍇ  false
+	// CX^XvXAt@Ŏw肳ĂȂR|[lgĂ  true
+	//  <Transform, Light> : ێ<Transform, Light, Camera> ꂾtrueԂ
+	template<class ...Components>
+	bool Contains() const
+	{
+		return entity_counts_ != 0 && archetype_.Contains<Components...>();
+	}
+
+	// Entityǉ
+	// Chunkt̏ꍇ͐VChunkǉ Chunk̃f[^̓Rs[Ȃ
+	// ǉꂽComponent̓ftHg\z grAɃftHg\złComponent̃f[^͖`
+	// entity ǉentity
+	// entity_manager ǉEntitẙi[ꏊXV
+	void AddEntity(Entity entity, EntityManager& entity_manager)
+	{
+		Chunk* chunk{ GetFreeChunk() };
+		const u32 index{ chunk->AddEntity(entity) };
+		entity_manager.GetLocation(entity) = { this, chunk, index };
+		++entity_counts_;
+	}
+
+	// EntityǉAeComponentlǉsɒڍ\z
+	// entity ǉentity
+	// entity_manager ǉEntitẙi[ꏊXV
+	// values ArchetypêׂĂComponent̒l EӒl̓[uč\z
+	template<class ...Components>
+	void AddEntity(Entity entity, EntityManager& entity_manager, Components&&... values)
+	{
+		Chunk* chunk{ GetFreeChunk() };
+		const u32 index{ chunk->AddEntity(entity, std::forward<Components>(values)...) };
+		entity_manager.GetLocation(entity) = { this, chunk, index };
+		++entity_counts_;
+	}
+
+	// Entity܂Ƃ߂Ēǉ
+	// KvChunkɊmۂAeChunkɂ͘AsƂĂ܂Ƃ߂Ċi[
+	// ǉsComponent͍\zȂ̂ŁAfuncŕK\z邱(Chunk::AddEntities)
+	// entities ǉentity
+	// entity_manager ǉEntitẙi[ꏊXV
+	// func i[ChunkƂɌĂ΂ void(Chunk& chunk, u32 index, u32 counts) i[sComponent\z
+	template<class Func>
+	void AddEntities(std::span<const Entity> entities, EntityManager& entity_manager, Func&& func)
+	{
+		const u64 free_counts{ chunks_.empty() ? 0 : chunk_capacity_ - chunks_.back()->GetEntityCounts() };
+		if(entities.size() > free_counts)
+		{
+			chunks_.reserve(chunks_.size() + (entities.size() - free_counts + chunk_capacity_ - 1) / chunk_capacity_);
+		}
+
+		while(!entities.empty())
+		{
+			Chunk* chunk{ GetFreeChunk() };
+			const u32 counts{ static_cast<u32>(std::min<u64>(entities.size(), chunk->GetCapacity() - chunk->GetEntityCounts())) };
+			const u32 index{ chunk->AddEntities(entities.first(counts)) };
+			for(u32 i = 0; i < counts; ++i)
+			{
+				entity_manager.GetLocation(entities[i]) = { this, chunk, index + i };
+			}
+			entity_counts_ += counts;
+
+			func(*chunk, index, counts);
+			entities = entities.subspan(counts);
+		}
+	}
+
+	// Entity̍폜
+	// ԍŌɊ蓖Ăf[^󂢂ƂɈړċl߂
+	// entity 폜entity
+	// entity_manager ړEntitẙi[ꏊXV
+	void RemoveEntity(Entity entity, EntityManager& entity_manager)
+	{
+		RemoveEntity(entity_manager.GetLocation(entity), entity_manager);
+	}
+
+	// Entity܂Ƃ߂č폜
+	// SĂ̍s폜Chunk͍sRs[ChunkƉAꕔ̍s폜Chunk̍s擪̒ʂԍɂĕׂ
+	// cChunǩ́A̍폜ΏۊO̍s1̑ňړĖ߁AړEntitẙi[ꏊ1񂾂XV
+	// Ōɖ̋󂢂s܂Ƃ߂č폜AɂȂChunk Chunk͏ȂƂ1cĂ
+	// locations 폜Entitẙi[ꏊ SĂArchetypeStoragê̂ŏd͕s Ԃ͖Ȃ
+	// entity_manager ړEntitẙi[ꏊXV
+	void RemoveEntities(std::span<const EntityLocation> locations, EntityManager& entity_manager)
+	{
+		if(locations.empty()) return;
+
+		Vector<u32> removed_counts(chunks_.size());
+		for(const EntityLocation& location : locations)
+		{
+			_ASSERT_EXPR(location.storage_ == this, L"ێĂȂEntity폜悤ƂȂł");
+			++removed_counts[location.chunk_->GetChunkIndex()];
+		}
+
+		// SĂ̍s폜ChunkChunk̔ԍ ɑSČ߂Ă
+		constexpr u32 kReleased{ std::numeric_limits<u32>::max() };
+		Vector<u32> new_chunk_indices(chunks_.size(), kReleased);
+		u32 kept_counts{};
+		u32 counts{};	// cChunk̍s̍v
+		for(u32 i = 0; i < chunks_.size(); ++i)
+		{
+			const bool is_last_kept{ i + 1 == chunks_.size() && kept_counts == 0 };
+			if(removed_counts[i] == chunks_[i]->GetEntityCounts() && !is_last_kept) continue;
+
+			new_chunk_indices[i] = kept_counts++;
+			counts += chunks_[i]->GetEntityCounts();
+		}
+
+		// cChunk̍폜śAl߂̒ʂԍ(Chunk̔ԍ~e+ChunkIndex)̏
+		// ȊOChunk͖tȂ̂Ŕԍi[ꏊ߂
+		Vector<u32> rows{};
+		for(const EntityLocation& location : locations)
+		{
+			const u32 chunk_index{ new_chunk_indices[location.chunk_->GetChunkIndex()] };
+			if(chunk_index != kReleased) rows.emplace_back(chunk_index * chunk_capacity_ + location.index_);
+		}
+		std::ranges::sort(rows);
+		_ASSERT_EXPR(std::ranges::adjacent_find(rows) == rows.end(), L"Entityw肳Ă܂");
+
+		for(u32 i = 0; i < chunks_.size(); ++i)
+		{
+			if(new_chunk_indices[i] == kReleased)
+			{
+				entity_counts_ -= removed_counts[i];
+				chunks_[i].reset();
+			}
+			else
+			{
+				chunks_[i]->SetChunkIndex(new_chunk_indices[i]);
+			}
+		}
+		std::erase(chunks_, nullptr);
+
+		const auto get_location = [this](u32 row) { return EntityLocation{ this, chunks_[row / chunk_capacity_].get(), row % chunk_capacity_ }; };
+
+		// [0, remain_counts)̌A[remain_counts, counts)̍폜ΏۊO̍sŌ납疄߂
+		const u32 remain_counts{ counts - static_cast<u32>(rows.size()) };
+		u64 back{ rows.size() };	// ܂΂ĂȂ̍폜s̏I[
+		u32 tail{ counts };
+		for(u64 i = 0; i < rows.size() && rows[i] < remain_counts; ++i)
+		{
+			--tail;
+			while(back > i && rows[back - 1] == tail)
+			{
+				--back;
+				--tail;
+			}
+
+			const EntityLocation dst{ get_location(rows[i]) };
+			const EntityLocation src{ get_location(tail) };
+			dst.chunk_->CopyEntity(dst.index_, *src.chunk_, src.index_);
+			entity_manager.GetLocation(dst.chunk_->GetEntity(dst.index_)) = dst;
+		}
+
+		// [remain_counts, counts)̍s폜 SĊ܂Chunk͂܂Ƃ߂ĉ
+		const u32 chunk_counts{ std::max((remain_counts + chunk_capacity_ - 1) / chunk_capacity_, 1u) };
+		chunks_.resize(chunk_counts);
+		Chunk& back_chunk{ *chunks_.back() };
+		back_chunk.RemoveBackEntities(back_chunk.GetEntityCounts() - (remain_counts - (chunk_counts - 1) * chunk_capacity_));
+		entity_counts_ -= counts - remain_counts;
+	}
+
+	// EntityʂArchetypeStorageɈړ
+	// ʂComponent̃f[^͈ړ̍sɒڃ[u\z(grAɃRs[łꍇ͗񂲂ƂɃRs[)
+	// ړɂȂComponentvalues̒l\zAvaluesɂȂ̂̓ftHg\z
+	// entity ړentity
+	// dst ړArchetypeStorage
+	// entity_manager ړEntitẙi[ꏊXV
+	// values ړɂȂComponent̒l
+	template<class ...Components>
+	void MoveEntity(Entity entity, ArchetypeStorage& dst, EntityManager& entity_manager, Components&&... values)
+	{
+		const EntityLocation src_location{ entity_manager.GetLocation(entity) };
+		_ASSERT_EXPR(src_location.storage_ == this, L"ێĂȂEntityړ悤ƂȂł");
+
+		Chunk* chunk{ dst.GetFreeChunk() };
+		const u32 index{ chunk->AddEntity(entity, *src_location.chunk_, src_location.index_, std::forward<Components>(values)...) };
+		entity_manager.GetLocation(entity) = { &dst, chunk, index };
+		++dst.entity_counts_;
+
+		RemoveEntity(src_location, entity_manager);
+	}
+
+	// ۑChunk̃f[^Entity𕜌AChunkƂĖɒǉ World::LoadŎgp
+	// EntityێĂȂ擪ChunkȂꍇ͂Chunku
+	// buffer ۑChunk::GetBuffer̃f[^ zuArchetypeStorageChunkƓꍇ̓Rs[ɂ̂܂Chunk̗̈ƂĎgp
+	// buffer_resource buffer̂܂܎gpꍇChunk̔jbuffer̉C郁\[X
+	// layout buffer̔zu
+	// entity_counts bufferɊi[ĂEntity̐ ChunkȊO͖tłȂ΂ȂȂ
+	// entity_manager Entitẙi[ꏊXV Entity͗LɂȂĂȂ΂ȂȂ
+	// ߂l buffer̂܂܎gpꍇtrue
+	bool RestoreChunk(u8* buffer, std::pmr::memory_resource& buffer_resource, const ChunkLayout& layout, u32 entity_counts, EntityManager& entity_manager)
+	{
+		_ASSERT_EXPR(chunks_.empty() || chunks_.back()->IsFull() || chunks_.back()->IsEmpty(), L"Chunktł͂܂");
+
+		const bool is_same_layout{ layout_ == layout };
+		if(!chunks_.empty() && chunks_.back()->IsEmpty()) chunks_.pop_back();
+
+		const u32 chunk_index{ static_cast<u32>(chunks_.size()) };
+		Chunk* chunk{ is_same_layout ?
+			chunks_.emplace_back(std::make_unique<Chunk>(archetype_, chunk_capacity_, chunk_index, buffer_resource, *change_version_, shared_values_, buffer)).get() :
+			chunks_.emplace_back(std::make_unique<Chunk>(archetype_, chunk_capacity_, chunk_index, *memory_resource_, *change_version_, shared_values_)).get() };
+		chunk->RestoreEntities(buffer, layout, entity_counts);
+
+		const std::span<const Entity> entities{ chunk->GetEntities() };
+		for(u32 i = 0; i < entity_counts; ++i)
+		{
+			entity_manager.GetLocation(entities[i]) = { this, chunk, i };
+		}
+		entity_counts_ += entity_counts;
+		return is_same_layout;
+	}
+
+	// ComponentǉƂ̈ړArchetypeStorage擾 ܂HƂȂꍇnullptr
+	ArchetypeStorage* GetAddEdge(ComponentId id) const { return id < add_edges_.size() ? add_edges_[id] : nullptr; }
+
+	// Component폜Ƃ̈ړArchetypeStorage擾 ܂HƂȂꍇnullptr
+	ArchetypeStorage* GetRemoveEdge(ComponentId id) const { return id < remove_edges_.size() ? remove_edges_[id] : nullptr; }
+
+	// Component̒ǉɂړLbV t̍폜̈ړɐݒ肷
+	// id ǉComponentID
+	// dst gArchetypeidArchetypeArchetypeStorage
+	void SetAddEdge(ComponentId id, ArchetypeStorage* dst)
+	{
+		_ASSERT_EXPR(!archetype_.Contains(id) && dst->archetype_.Contains(id), L"ړArchetype܂");
+
+		if(id >= add_edges_.size()) add_edges_.resize(id + 1);
+		if(id >= dst->remove_edges_.size()) dst->remove_edges_.resize(id + 1);
+		add_edges_[id] = dst;
+		dst->remove_edges_[id] = this;
+	}
+
+	// LComponent폜Ƃ̈ړLbV
+	// LComponent̒ǉ͒lɂĈړ悪ς̂ŃLbVȂ
+	// id 폜鋤LComponentID
+	// dst gArchetypeidArchetypeArchetypeStorage
+	void SetRemoveEdge(ComponentId id, ArchetypeStorage* dst)
+	{
+		_ASSERT_EXPR(archetype_.Contains(id) && !dst->archetype_.Contains(id), L"ړArchetype܂");
+
+		if(id >= remove_edges_.size()) remove_edges_.resize(id + 1);
+		remove_edges_[id] = dst;
+	}
+
+	// EntityێĂȂꍇ͎cĂChunkAChunk̕\̗]ȗeʂ
+	// ߂l Chunk̐
+	u32 ShrinkToFit()
+	{
+		u32 ret{};
+		if(entity_counts_ == 0 && !chunks_.empty())
+		{
+			ret = static_cast<u32>(chunks_.size());
+			chunks_.clear();
+		}
+		chunks_.shrink_to_fit();
+		return ret;
+	}
+
+	// ̎gp entity_map_bytes_EntityManager1EntitỹTCY狁߂
+	ArchetypeMemoryStats GetMemoryStats() const
+	{
+		ArchetypeMemoryStats ret{ this, entity_counts_, static_cast<u32>(chunks_.size()) * chunk_capacity_, static_cast<u32>(chunks_.size()) };
+		ret.used_bytes_ = static_cast<u64>(entity_counts_) * (archetype_.GetSize() + sizeof(Entity));
+		ret.allocated_bytes_ = static_cast<u64>(chunks_.size()) * layout_.buffer_size_;
+		ret.overhead_bytes_ = chunks_.capacity() * sizeof(UniquePtr<Chunk>);
+		for(const UniquePtr<Chunk>& chunk : chunks_) ret.overhead_bytes_ += chunk->GetOverheadBytes();
+		ret.entity_map_bytes_ = static_cast<u64>(entity_counts_) * EntityManager::GetSlotSize();
+		return ret;
+	}
+
+	[[nodiscard]] const Archetype& GetArchetype() const { return archetype_; }
+	[[nodiscard]] std::span<const SharedComponentValue> GetSharedComponentValues() const { return shared_values_; }
+	[[nodiscard]] const Vector<UniquePtr<Chunk>>& GetChunks() const { return chunks_; }
+	u32 GetEntityCounts() const { return entity_counts_; }
+	u32 GetChunkCapacity() const { return chunk_capacity_; }
+
+	// Chunk̗̔zu ChunkێĂȂꍇ擾ł
+	[[nodiscard]] const ChunkLayout& GetChunkLayout() const { return layout_; }
+
+private:
+
+	// Entityǉł閖Chunk Chunkt܂ChunkێĂȂꍇ͒ǉ
+	Chunk* GetFreeChunk()
+	{
+		if(chunks_.empty() || chunks_.back()->IsFull()) AddChunk();
+		return chunks_.back().get();
+	}
+
+	// ɋChunkǉ
+	void AddChunk()
+	{
+		chunks_.emplace_back(std::make_unique<Chunk>(archetype_, chunk_capacity_, static_cast<u32>(chunks_.size()), *memory_resource_, *change_version_, shared_values_));
+	}
+
+	// w肳ꂽꏊEntity폜
+	// ԍŌɊ蓖Ăf[^󂢂ƂɈړċl߂
+	// location 폜Entitẙi[ꏊ EntityManagerێĂ̂Ƃ͌Ȃ
+	// entity_manager ړEntitẙi[ꏊXV
+	void RemoveEntity(EntityLocation location, EntityManager& entity_manager)
+	{
+		_ASSERT_EXPR(location.storage_ == this, L"ێĂȂEntity폜悤ƂȂł");
+
+		Chunk& back_chunk{ *chunks_.back() };
+		const u32 back_index{ back_chunk.GetEntityCounts() - 1 };
+
+		// 폜̂EntityłȂΖEntity󂢂ƂɈړ
+		if(location.chunk_ != &back_chunk || location.index_ != back_index)
+		{
+			const Entity back_entity{ back_chunk.GetEntity(back_index) };
+			location.chunk_->CopyEntity(location.index_, back_chunk, back_index);
+			entity_manager.GetLocation(back_entity) = location;
+		}
+		back_chunk.RemoveBackEntity();
+		--entity_counts_;
+
+		// ɂȂChunk͉ 擪Chunk͎cĂ
+		if(back_chunk.IsEmpty() && chunks_.size() > 1)
+		{
+			chunks_.pop_back();
+		}
+	}
+
+private:
+
+	Archetype archetype_{};
+	std::pmr::memory_resource* memory_resource_{};
+	const u32* change_version_{};	// World̕ύXo[W
+	Vector<SharedComponentValue> shared_values_{};	// ComponentId̏ɕ񂾋LComponent̒l
+	Vector<UniquePtr<Chunk>> chunks_{};	// 擪l߂Ďgp ChunkȊO͏ɖt
+	u32 chunk_capacity_{};	// Chunk1Ɋi[łEntity̐
+	ChunkLayout layout_{};	// SĂChunkŋʂ̗̔zu
+	u32 entity_counts_{};	// SChunkێĂEntity̍v
+
+	Vector<ArchetypeStorage*> add_edges_{};		// ComponentIdIndexƂAComponentǉƂ̈ړ
+	Vector<ArchetypeStorage*> remove_edges_{};	// ComponentIdIndexƂAComponent폜Ƃ̈ړ
+};
@@ -5,256 +5,976 @@
 #include "Archetype.h"
 #include "Entity.h"
 #include "ComponentArray.h"
+#include "SharedComponentStore.h"
 
+// Chunkbuffer_̗̔zu
+// World::SaveŕۑALoadŎs̃oCiChunkƓzur
+struct ChunkLayout
+{
+	u32 capacity_{};
+	u32 buffer_size_{};
+	u32 entity_offset_{};
+	Vector<u32> stream_offsets_{};	// ComponentId̏ɁAeComponent̗̃ItZbgׂ
+	Vector<u32> enabled_offsets_{};	// ComponentId̏ɁAeComponent̗L/̃rbg̃ItZbgׂ EnableablełȂꍇu32̍ől
+
+	bool operator==(const ChunkLayout&) const = default;
+};
+
+// ŒTCỸubN
+// 1ArchetypeɑEntityComponentf[^(Component)ƂɘAĕێ
+// eʂȂȂꍇArchetypeStorageVChunkǉ̂ŁÃf[^Rs[邱Ƃ͂Ȃ
 class Chunk
 {
 public:
-	Chunk() = default;
-	~Chunk() = default;
+	// 1Chunk̃TCY(oCg)
+	static constexpr u32 kChunkSize{ 16 * 1024 };
 
-	Chunk(const Chunk&) = delete;
-	Chunk& operator=(const Chunk&) = delete;
+	// e(Component̗Entity̗)̐擪AhX̍ŏ̃ACg(oCg)
+	// LbVCɑāA̐擪ʂ̗ƃLbVCLȂ悤ɂ
+	// Componentalignof傫ꍇ͂Component̗񂾂alignofɑ
+	static constexpr u32 kColumnAlignment{ 64 };
 
-	Chunk(Chunk&& other) noexcept
-	{
-		this->archetype_ = std::move(other.archetype_);
-		this->buffer_ = std::move(other.buffer_);
-		this->size_ = std::move(other.size_);
-		this->capacity_ = std::move(other.capacity_);
-		this->entity_index_ = std::move(other.entity_index_);
-		this->component_offsets_ = std::move(other.component_offsets_);
-	}
-	Chunk& operator=(Chunk&& other) noexcept
-	{
-		this->archetype_ = std::move(other.archetype_);
-		this->buffer_ = std::move(other.buffer_);
-		this->size_ = std::move(other.size_);
-		this->capacity_ = std::move(other.capacity_);
-		this->entity_index_ = std::move(other.entity_index_);
-		this->component_offsets_ = std::move(other.component_offsets_);
-		return *this;
-	}
-	
-	// Chunk̍쐬
-	// size ̃`NɊi[Entity̐
-	// ...Components gp\̃R|[lg
-	template<class ...Components>
-	static Chunk Create(u32 size)
-	{
-		//_ASSERT_EXPR(size > 0, L"0傫lw肵Ă");
+	// L/̃rbg1[h̍s
+	static constexpr u32 kEnabledBitsPerWord{ 64 };
 
-		Chunk chunk;
-		chunk.archetype_ = Archetype::Create<Components...>();
-		chunk.size_ = size;
-		chunk.capacity_ = size;
-		chunk.buffer_ = std::make_unique<u8[]>(size * chunk.archetype_.size_);
-		u32 offset{};
-		for(auto it = chunk.archetype_.component_ids_.begin(); it != chunk.archetype_.component_ids_.end(); ++it)
+	// ArchetypeEntity1ChunkɊi[ł鐔vZ
+	// ArchetypeComponent̍vTCY + Entitỹ̗TCY + L/̃rbgƁA񂲂Ƃ̃ACĝ߂̗]kChunkSizeɎ܂悤ɂ
+	// 1EntitykChunkSizeɎ܂ȂقǑ傫ꍇłŒ1͊i[ł悤ɂ
+	static u32 CalculateCapacity(const Archetype& archetype)
+	{
+		u32 padding{ kColumnAlignment };	// Entity̗
+		u32 enabled_bits{};	// 1s̃rbg
+		for(const ComponentId id : archetype.component_ids_)
 		{
-			const ComponentId id{ static_cast<u64>(*it) };
-			chunk.component_offsets_.insert({ id, offset });
-			offset += size * chunk.archetype_.component_size_.at((id));
+			padding += static_cast<u32>(ComponentTypeRegistry::GetStreams(id).size()) * GetColumnAlignment(id);
+			if(ComponentTypeRegistry::IsEnableable(id))
+			{
+				// [hPʂɐ؂グ镪]Ɋ܂߂
+				padding += kColumnAlignment + static_cast<u32>(sizeof(u64));
+				++enabled_bits;
+			}
 		}
 
-		return chunk;
+		const u32 stride_bits{ (archetype.GetSize() + static_cast<u32>(sizeof(Entity))) * 8 + enabled_bits };
+		return kChunkSize > padding ? std::max((kChunkSize - padding) * 8 / stride_bits, 1u) : 1u;
 	}
 
-	// SComponentsێĂ邩
-	//  <Transform, Camera, Light> : ێ<Transform, Camera, Light, Mesh> ̏ꍇfalseԂ
-	// ɈvĂƂtrueԂ
-	template<class ...Components>
-	bool IsSame() const
+	// archetype ChunkɊi[EntityArchetype ArchetypeStorageێĂ̂QƂ
+	// capacity ChunkɊi[łEntity̐
+	// chunk_index ArchetypeStorageł̂Chunk̔ԍ
+	// memory_resource buffer_̊mۂɎgp郁\[X Chunk蒷ĂȂ΂ȂȂ
+	// change_version ɏ܂ꂽƂɋL^World̕ύXo[W Chunk蒷ĂȂ΂ȂȂ
+	// shared_values Archetype̋LComponent̒l ComponentId̏ɕсAArchetype̋LComponentׂĊ܂
+	// buffer nullptrłȂꍇmemory_resourcemۂɂ̗̈̂܂܎gp jmemory_resourceɉC
+	//        World::LoadŃ}bvt@C̃f[^荞ޏꍇɎgp zu(GetLayout)ŕۑf[^łȂ΂ȂȂ
+	Chunk(const Archetype& archetype, u32 capacity, u32 chunk_index, std::pmr::memory_resource& memory_resource, const u32& change_version,
+		std::span<const SharedComponentValue> shared_values, u8* buffer = nullptr)
+		: archetype_(&archetype), memory_resource_(&memory_resource), change_version_(&change_version), capacity_(capacity), chunk_index_(chunk_index)
 	{
-		// ̐ƕێĂR|[lg̐ႤȂ瓯Ȃ킯Ȃ
-		if(sizeof...(Components) != this->archetype_.component_ids_.size()) return false;
+		_ASSERT_EXPR(capacity > 0, L"0傫lw肵Ă");
 
-		// ɓ^w肳Ăꍇfalse
-		// ifň̐ArchetypeێĂComponent̐vĂ邱Ƃ킩
-		// Archetype͓^dĎƂ͂Ȃ^܂łƂƂ͕ێĂR|[lg̐Ⴄ
-		if(IsArgsHasSameType<Components...>()) return false;
+		// ComponentId̂܂IndexƂĎgpł悤ɍőID܂ł̔zmۂ
+		const ComponentId max_id{ archetype.component_ids_.empty() ? 0 : archetype.component_ids_.back() };
+		columns_.assign(max_id + 1, Column{});
 
-		return this->archetype_.Contains<Components...>();
-	}
+		// ComponentƂɗ(SoȀꍇ̓tB[h̗vfƂɕ̗)mۂ
+		// ̐擪kColumnAlignmentȏɑ̂ŁA񓯎mdȂ邱ƂȂ
+		u32 offset{};
+		buffer_alignment_ = kColumnAlignment;
+		for(const ComponentId id : archetype.component_ids_)
+		{
+			const std::span<const ComponentStream> component_streams{ ComponentTypeRegistry::GetStreams(id) };
+			const u32 alignment{ GetColumnAlignment(id) };
+			columns_[id] = Column{ static_cast<u32>(streams_.size()), static_cast<u32>(component_streams.size()), ComponentTypeRegistry::GetSize(id) };
+			columns_[id].lifecycle_ = ComponentTypeRegistry::GetLifecycle(id);
+			buffer_alignment_ = std::max(buffer_alignment_, alignment);
+
+			for(const ComponentStream& component_stream : component_streams)
+			{
+				offset = AlignOffset(offset, alignment);
+				streams_.emplace_back(Stream{ offset, component_stream.size_, component_stream.field_offset_ });
+				offset += capacity * component_stream.size_;
+			}
+		}
 
-	// w肳ꂽComponentׂĕێĂ邩ǂ
-	// ێĂ邯EntityȂ or łێĂȂꍇ  false
-	// CX^XvXAt@Ŏw肳ĂȂR|[lgĂ  true
-	//  <Transform, Light> : ێ<Transform, Light, Camera> ꂾtrueԂ
-	template<class ...Components>
-	bool Contains() const
+		// LComponent͗̑ChunkŜ1̒lQƂ
+		for(const SharedComponentValue& shared_value : shared_values)
+		{
+			_ASSERT_EXPR(HasComponent(shared_value.id_) && ComponentTypeRegistry::IsShared(shared_value.id_), L"Archetype̋LComponentł͂܂");
+			columns_[shared_value.id_].shared_value_ = shared_value;
+		}
+
+		// esǂEntitỹf[^Ȃ̂肷邽߂Entity̗ێ
+		offset = AlignOffset(offset, kColumnAlignment);
+		entity_offset_ = offset;
+		offset += capacity * static_cast<u32>(sizeof(Entity));
+
+		// ComponentEnableableꉻĂComponent͍sƂ̗L/̃rbgێ
+		for(const ComponentId id : archetype.component_ids_)
+		{
+			if(!ComponentTypeRegistry::IsEnableable(id)) continue;
+
+			offset = AlignOffset(offset, kColumnAlignment);
+			columns_[id].enabled_offset_ = offset;
+			offset += GetEnabledWordCounts(capacity) * static_cast<u32>(sizeof(u64));
+		}
+
+		buffer_size_ = offset;
+		buffer_ = buffer ? buffer : static_cast<u8*>(memory_resource_->allocate(buffer_size_, buffer_alignment_));
+	}
+	~Chunk()
 	{
-		return !entity_index_.empty() && archetype_.Contains<Components...>();
+		DestroyRows(0, entity_counts_);
+		memory_resource_->deallocate(buffer_, buffer_size_, buffer_alignment_);
 	}
 
+	Chunk(const Chunk&) = delete;
+	Chunk& operator=(const Chunk&) = delete;
+	Chunk(Chunk&&) = delete;
+	Chunk& operator=(Chunk&&) = delete;
+
 	// Component̃f[^擾
-	// T 擾Componenť^
-	// entity ComponentێĂEntityID
+	// Component 擾Componenť^
+	// index ChunkEntityIndex
 	template<class Component>
-	Component GetComponentData(Entity entity)
+	Component GetComponentData(u32 index) const
 	{
-		_ASSERT_EXPR(entity_index_.contains(entity), "ێĂȂEntityw肵Ȃł");
-
 		const ComponentId id{ GET_COMPONENT_ID(Component) };
-		const u64 size{ sizeof(Component) };
-		_ASSERT_EXPR(size == archetype_.component_size_.at(id), L"ArchetypeɕۑĂTCYsizeof(T)̃TCYقȂ܂");
-
-		const u32 index{ entity_index_.at(entity) };
-		_ASSERT_EXPR(size != 0, L"f[^̃TCY0ł");
-		_ASSERT_EXPR(index < size, L"TCY傫Ȓl̃CfbNXo܂");
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		_ASSERT_EXPR(TagComponent<Component> || SharedComponent<Component> || sizeof(Component) == columns_[id].size_, L"ArchetypeɕۑĂTCYsizeof(T)̃TCYقȂ܂");
+		_ASSERT_EXPR(index < entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
 
-		const u64 offset_bytes{ component_offsets_.at(id) + index * size };
-		Component ret;
-		std::memcpy(&ret, &buffer_[offset_bytes], size);
+		if constexpr(SharedComponent<Component>)
+		{
+			return GetSharedComponent<Component>();
+		}
+		else if constexpr(!std::is_trivially_copyable_v<Component>)
+		{
+			return *static_cast<const Component*>(GetRowPointer(id, index));
+		}
+		else
+		{
+			Component ret;
+			ReadRow(id, index, &ret);
 
-		return ret;
+			return ret;
+		}
 	}
 
 	// w肳ꂽCompoent̔z擾
 	//  :		߂lCX^XƂĕێ̂͂ Entity̒ǉ폜ɂ郁̕ϓۏ؂łȂ
 	//				̂߃XR[vł݂̂̎gpƂAgƂ͓sx̊֐gComponentArray擾邱
-	// T 擾Componenť^
+	// T 擾Componenť^ consttȂꍇ͏܂̂Ƃė̕ύXo[WXV
 	template<class Component>
 	ComponentArray<Component> GetComponentArray()
 	{
-		const ComponentId id{ GET_COMPONENT_ID(Component) };
-		const u32 size{ size_ - capacity_ };
+		static_assert(!SoAComponent<std::remove_cv_t<Component>>, "SoAŊi[ĂComponent̔z͎擾ł܂ ChunkView::GetFieldgpĂ");
+		static_assert(!TagComponent<std::remove_cv_t<Component>>, "^OComponent͗Ȃ̂Ŕz͎擾ł܂");
+		static_assert(!SharedComponent<std::remove_cv_t<Component>>, "LComponent͗Ȃ̂Ŕz͎擾ł܂ GetSharedComponentgpĂ");
 
-		if(!archetype_.Contains<Component>())
-		{
-			_ASSERT_EXPR(archetype_.Contains<Component>(), L"ێĂȂ^w肳܂");
-		}
+		const ComponentId id{ GET_COMPONENT_ID(Component) };
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		if constexpr(!std::is_const_v<Component>) MarkChanged(id);
 
-		const u32 offset{ component_offsets_.at(id) };
+		const u32 offset{ streams_[columns_[id].stream_begin_].offset_ };
 		void* begin{ &buffer_[offset] };
-		ComponentArray<Component> ret(static_cast<Component*>(begin), size);
+		ComponentArray<Component> ret(static_cast<Component*>(begin), entity_counts_);
+
+		return ret;
+	}
+
+	// w肳ꂽComponent̗擾
+	// GetComponentArrayƓwA擪kColumnAlignmentɑĂ邱ƂRpCɓ`̂
+	// Ŝ܂Ƃ߂ď郋[vxNg₷ EntityێĂȂꍇ͋ɂȂ
+	//  : GetComponentArrayƓlɃXR[vł̂ݎgp邱
+	// Component 擾Componenť^ consttꍇ͓ǂݍݐpɂȂAtȂꍇ͗̕ύXo[WXV
+	template<class Component>
+	std::span<Component> GetComponentSpan()
+	{
+		static_assert(!SoAComponent<std::remove_cv_t<Component>>, "SoAŊi[ĂComponent̗͎擾ł܂ GetFieldSpansgpĂ");
+		static_assert(!TagComponent<std::remove_cv_t<Component>>, "^OComponent͗Ȃ̂Ŏ擾ł܂ With<T>gpĂ");
+		static_assert(!SharedComponent<std::remove_cv_t<Component>>, "LComponent͗Ȃ̂Ŏ擾ł܂ GetSharedComponentgpĂ");
+
+		const ComponentId id{ GET_COMPONENT_ID(Component) };
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		_ASSERT_EXPR(sizeof(Component) == columns_[id].size_, L"ArchetypeɕۑĂTCYsizeof(T)̃TCYقȂ܂");
+		if constexpr(!std::is_const_v<Component>) MarkChanged(id);
+
+		Component* begin{ reinterpret_cast<Component*>(&buffer_[streams_[columns_[id].stream_begin_].offset_]) };
+		return { std::assume_aligned<kColumnAlignment>(begin), entity_counts_ };
+	}
+
+	// SoAŊi[ĂComponent̃tB[h̗擾
+	// float2, float3, float4̃tB[h͗vfƂ̗ɂȂ([0]x, [1]y...) ȊÕtB[h[0]
+	//  : GetComponentArrayƓlɃXR[vł̂ݎgp邱
+	// Field SoALayout::kFieldsɗ񋓂oϐ̃|C^
+	// kIsConst truȅꍇ͓ǂݍݐp̗Ԃ falsȅꍇ͗̕ύXo[WXV
+	template<auto Field, bool kIsConst = false>
+	auto GetFieldSpans()
+	{
+		using Traits = MemberPointerTraits<decltype(Field)>;
+		using Lanes = SoAFieldLanes<typename Traits::MemberType>;
+		using LaneType = std::conditional_t<kIsConst, const typename Lanes::LaneType, typename Lanes::LaneType>;
+
+		constexpr u32 field_stream_index{ ComponentTypeRegistry::GetFieldStreamIndex<Field>() };
+		static_assert(field_stream_index != std::numeric_limits<u32>::max(), "SoALayout::kFieldsɗ񋓂ĂȂtB[hł");
 
+		const ComponentId id{ GET_COMPONENT_ID(typename Traits::ClassType) };
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		if constexpr(!kIsConst) MarkChanged(id);
+
+		std::array<std::span<LaneType>, Lanes::kCounts> ret{};
+		for(u32 i = 0; i < Lanes::kCounts; ++i)
+		{
+			LaneType* begin{ reinterpret_cast<LaneType*>(&buffer_[streams_[columns_[id].stream_begin_ + field_stream_index + i].offset_]) };
+			ret[i] = { std::assume_aligned<kColumnAlignment>(begin), entity_counts_ };
+		}
 		return ret;
 	}
 
 	// Component̃f[^Zbg
 	// T ZbgComponenť^
-	// entity ComponentێĂEntityID
+	// index ChunkEntityIndex
 	// t ZbgComponent̃f[^
 	template<class Component>
-	void SetComponentData(Entity entity, const Component& t)
+	void SetComponentData(u32 index, const Component& t)
+	{
+		static_assert(!SharedComponent<Component>, "LComponent̒lChunkƂȂ̂ōsɂ͏߂܂ World::SetSharedComponentgpĂ");
+		const ComponentId id{ GET_COMPONENT_ID(Component) };
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		_ASSERT_EXPR(index < entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
+
+		MarkChanged(id);
+		if constexpr(std::is_trivially_copyable_v<Component>) WriteRow(id, index, &t);
+		else *static_cast<Component*>(GetRowPointer(id, index)) = t;
+	}
+
+	// Entity𖖔ɒǉ
+	// ǉꂽComponent̓ftHg\z grAɃftHg\złComponent̃f[^͖` L/͗LɂȂ
+	// entity ǉentity
+	// ߂l ChunkEntityIndex
+	u32 AddEntity(Entity entity)
+	{
+		const u32 index{ AddRow(entity) };
+		ConstructRows(index, 1);
+		return index;
+	}
+
+	// Entity𖖔ɒǉAeComponentl璼ڍ\z
+	// EӒlœnComponent̓[uč\z LComponent̒lChunkƂȂ̂Ŗ L/͗LɂȂ
+	// entity ǉentity
+	// values ArchetypêׂĂComponent̒l Ԃ͖Ȃ
+	// ߂l ChunkEntityIndex
+	template<class ...Components>
+	u32 AddEntity(Entity entity, Components&&... values)
+	{
+		_ASSERT_EXPR(archetype_->component_ids_.size() == sizeof...(Components) && (HasComponent(GET_COMPONENT_ID(Components)) && ...), L"ArchetypeComponentƈقȂlw肳܂");
+
+		const u32 index{ AddRow(entity) };
+		(ConstructComponent(index, std::forward<Components>(values)), ...);
+		return index;
+	}
+
+	// EntityʂArchetypeChunk̍s疖ɒǉ(L/܂)
+	// Entityɑ΂Component̒ǉ폜ArchetypeړƂɎgp
+	// ʂComponent̓[u\z(grAɃRs[łꍇ͗񂲂Ƃmemcpy)AChunkɂȂComponentvalues̒l\z
+	// valuesœnȂChunkɂȂComponent̓ftHg\z VǉꂽComponent͗LɂȂ
+	// Rs[̍s̓[ȕԂŎĉŁǍɍ폜邱
+	// entity ǉentity
+	// src Rs[Chunk
+	// src_index Rs[ChunkIndex
+	// values ChunkɂȂComponent̒l EӒl̓[uč\z
+	// ߂l ChunkEntityIndex
+	template<class ...Components>
+	u32 AddEntity(Entity entity, Chunk& src, u32 src_index, Components&&... values)
+	{
+		_ASSERT_EXPR(src_index < src.entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
+		_ASSERT_EXPR(((HasComponent(GET_COMPONENT_ID(std::remove_cvref_t<Components>)) && !src.HasComponent(GET_COMPONENT_ID(std::remove_cvref_t<Components>))) && ...), L"ChunkɂȂComponent̒lw肵Ă");
+
+		const u32 index{ AddRow(entity) };
+		for(const ComponentId id : archetype_->component_ids_)
+		{
+			const Column& column{ columns_[id] };
+			if(!src.HasComponent(id))
+			{
+				const bool has_value{ ((id == GET_COMPONENT_ID(std::remove_cvref_t<Components>)) || ...) };
+				if(!has_value && column.lifecycle_.default_construct_) column.lifecycle_.default_construct_(GetRowPointer(id, index));
+				continue;
+			}
+
+			if(column.lifecycle_.move_construct_) column.lifecycle_.move_construct_(GetRowPointer(id, index), src.GetRowPointer(id, src_index));
+			else CopyStreams(id, index, src, src_index);
+			if(column.enabled_offset_ != kInvalidIndex) WriteEnabledBit(id, index, src.IsComponentEnabled(id, src_index));
+		}
+		(ConstructComponent(index, std::forward<Components>(values)), ...);
+		return index;
+	}
+
+	// Entity𖖔ɂ܂Ƃ߂Ēǉ
+	// ǉsComponent͍\zȂ̂ŁAConstructRowsAConstructComponentDataACloneRoŵꂩŌĂяoׂĂComponent\z邱
+	// L/͗LɂȂ
+	// entities ǉentity 󂫗eʈȉ̐łȂ΂ȂȂ
+	// ߂l ǉ擪EntityChunkIndex ȍ~Entity͘AĊi[
+	u32 AddEntities(std::span<const Entity> entities)
+	{
+		_ASSERT_EXPR(entities.size() <= capacity_ - entity_counts_, L"󂫗eʂ葽EntityǉȂł");
+
+		const u32 index{ entity_counts_ };
+		std::memcpy(&buffer_[entity_offset_ + index * sizeof(Entity)], entities.data(), entities.size_bytes());
+		entity_counts_ += static_cast<u32>(entities.size());
+		MarkAllAdded();
+		EnableRows(index, static_cast<u32>(entities.size()));
+		return index;
+	}
+
+	// AddEntitiesŒǉ[index, index + counts)̍s̃grAɃftHg\złȂComponentftHg\z
+	// grAɃftHg\złComponent̃f[^͖`
+	void ConstructRows(u32 index, u32 counts)
+	{
+		for(const ComponentId id : archetype_->component_ids_)
+		{
+			const auto construct{ columns_[id].lifecycle_.default_construct_ };
+			if(!construct) continue;
+			for(u32 i = index; i < index + counts; ++i) construct(GetRowPointer(id, i));
+		}
+	}
+
+	// AddEntitiesŒǉAsComponent𓯂lRs[\z
+	// ^OƋLComponent͗Ȃ̂ŉȂ
+	// Component \zComponenť^
+	// index 擪ChunkIndex
+	// counts \zs̐
+	// t \zl
+	template<class Component>
+	void ConstructComponentData(u32 index, u32 counts, const Component& t)
 	{
-		VerifyHolding<Component>();
+		_ASSERT_EXPR(index + counts <= entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
+		for(u32 i = index; i < index + counts; ++i) ConstructComponent(i, t);
+	}
 
+	// AsComponent̃f[^𓯂lŖ߂
+	// Component ZbgComponenť^
+	// index 擪ChunkIndex
+	// counts ߂s̐
+	// t ZbgComponent̃f[^
+	template<class Component>
+	void FillComponentData(u32 index, u32 counts, const Component& t)
+	{
+		static_assert(!SharedComponent<Component>, "LComponent̒lChunkƂȂ̂ōsɂ͏߂܂ World::SetSharedComponentgpĂ");
 		const ComponentId id{ GET_COMPONENT_ID(Component) };
-		const u32 structure_stride{ sizeof(Component) };
-		const u32 index{ entity_index_.at(entity) };
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		_ASSERT_EXPR(index + counts <= entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
 
-		_ASSERT_EXPR(archetype_.Contains<Component>(), L"ێĂȂ^w肳܂");
-		const u32 offset{ component_offsets_.at(id) +  index * structure_stride };
-		void* begin{ &buffer_[offset] };
+		MarkChanged(id);
+		for(u32 i = 0; i < counts; ++i)
+		{
+			if constexpr(std::is_trivially_copyable_v<Component>) WriteRow(id, index + i, &t);
+			else *static_cast<Component*>(GetRowPointer(id, index + i)) = t;
+		}
+	}
+
+	// ʂChunk̍sf[^Chunk̍sɏ㏑(Entity̗ƗL/܂)
+	// ArchetypeChunkmł̂ݎgp\ grAɃRs[łȂComponent̓[ûŁARs[̍s͂̌ɍ폜邱
+	// index ㏑邱ChunkIndex
+	// src Rs[Chunk
+	// src_index Rs[ChunkIndex
+	void CopyEntity(u32 index, Chunk& src, u32 src_index)
+	{
+		_ASSERT_EXPR(archetype_ == src.archetype_, L"قȂArchetypeChunkԂŃRs[Ȃł");
+		_ASSERT_EXPR(index < entity_counts_ && src_index < src.entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
 
-		std::memcpy(begin, &t, structure_stride);
+		for(const ComponentId id : archetype_->component_ids_)
+		{
+			CopyColumn(id, index, src, src_index);
+			MarkChanged(id);
+			if(columns_[id].enabled_offset_ != kInvalidIndex) WriteEnabledBit(id, index, src.IsComponentEnabled(id, src_index));
+		}
+		std::memcpy(&buffer_[entity_offset_ + index * sizeof(Entity)], &src.buffer_[src.entity_offset_ + src_index * sizeof(Entity)], sizeof(Entity));
 	}
 
-	// Entityǉ
-	// entity ǉentityID
-	void AddEntity(Entity entity)
+	// ʂChunk1sComponent̃f[^ƗL/AAddEntitiesŒǉChunk̘Asɕ(Entity̗͊܂܂Ȃ)
+	// World::InstantiateŃvnu𕡐ƂɎgp Rs[ɂȂComponent(Prefab)͖
+	// grAɃRs[łȂComponent͍sƂɃRs[\z
+	// ȊO͗񂲂Ƃɐ擪1sRs[ǂݍ݁Aȍ~͕ς݂͈̔͂{XɃRs[̂ŁAmemcpỷ񐔂͍s̑ΐōς
+	// index ̐擪̂ChunkIndex
+	// counts s̐
+	// src Rs[Chunk ChunkComponentׂĕێĂȂ΂ȂȂ Chunkgł悢
+	// src_index Rs[ChunkIndex [index, index + counts)Ɋ܂܂ĂĂ͂ȂȂ
+	void CloneRow(u32 index, u32 counts, const Chunk& src, u32 src_index)
 	{
-		if(entity_index_.contains(entity)) _ASSERT_EXPR(FALSE, L"łɎĂEntitynȂł");
+		_ASSERT_EXPR(index + counts <= entity_counts_ && src_index < src.entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
+		_ASSERT_EXPR(&src != this || src_index < index || src_index >= index + counts, L"̍sɃRs[̍s܂܂Ă܂");
+		if(counts == 0) return;
 
-		if(capacity_ == 0)
+		for(const ComponentId id : archetype_->component_ids_)
 		{
-			Resize(size_ * 2);
+			_ASSERT_EXPR(src.HasComponent(id), L"Rs[ChunkێĂȂComponent܂");
+			const Column& column{ columns_[id] };
+			MarkChanged(id);
+
+			if(column.lifecycle_.copy_construct_)
+			{
+				const void* src_row{ src.GetRowPointer(id, src_index) };
+				for(u32 i = index; i < index + counts; ++i) column.lifecycle_.copy_construct_(GetRowPointer(id, i), src_row);
+			}
+			else
+			{
+				const Column& src_column{ src.columns_[id] };
+				for(u32 i = 0; i < column.stream_counts_; ++i)
+				{
+					const Stream& stream{ streams_[column.stream_begin_ + i] };
+					CopyStream(stream, index, src, src.streams_[src_column.stream_begin_ + i], src_index);
+
+					u8* begin{ &buffer_[stream.offset_ + index * stream.element_size_] };
+					for(u32 copied = 1; copied < counts; copied *= 2)
+					{
+						std::memcpy(begin + copied * stream.element_size_, begin, std::min(copied, counts - copied) * stream.element_size_);
+					}
+				}
+			}
+
+			// ǉs͗LɂȂĂ̂ŁȀꍇ
+			if(column.enabled_offset_ != kInvalidIndex && !src.IsComponentEnabled(id, src_index))
+			{
+				for(u32 i = index; i < index + counts; ++i) WriteEnabledBit(id, i, false);
+			}
 		}
-		u32 index{ size_ - capacity_ };
-		index_entity_map_.insert({ index, entity });
-		entity_index_.insert({ entity, index });
+	}
+
+	// Entity폜 grAɃRs[łȂComponent͔j
+	// rEntity폜ꍇ͖EntityCopyEntityňړĂĂԂ
+	void RemoveBackEntity()
+	{
+		_ASSERT_EXPR(entity_counts_ > 0, L"EntityێĂȂChunk폜悤ƂȂł");
+		DestroyRows(entity_counts_ - 1, entity_counts_);
+		--entity_counts_;
+	}
+
+	// countsEntity܂Ƃ߂č폜 grAɃRs[łȂComponent͔j
+	void RemoveBackEntities(u32 counts)
+	{
+		_ASSERT_EXPR(counts <= entity_counts_, L"ێĂEntity̐葽폜悤ƂȂł");
+		DestroyRows(entity_counts_ - counts, entity_counts_);
+		entity_counts_ -= counts;
+	}
+
+	// w肳ꂽIndexɊi[ĂEntity擾
+	Entity GetEntity(u32 index) const
+	{
+		_ASSERT_EXPR(index < entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
+		return *reinterpret_cast<const Entity*>(&buffer_[entity_offset_ + index * sizeof(Entity)]);
+	}
 
-		--capacity_;
+	// Entity̗擾 Index͊eComponent̗ƑΉĂ
+	//  : GetComponentArrayƓlɃXR[vł̂ݎgp邱
+	std::span<const Entity> GetEntities() const
+	{
+		return { std::assume_aligned<kColumnAlignment>(reinterpret_cast<const Entity*>(&buffer_[entity_offset_])), entity_counts_ };
 	}
 
-	// Entity̍폜
-	// entity 폜entityID
-	void RemoveEntity(Entity entity)
+	// buffer_̗̔zu ArchetypeƗeʂChunkłΏɓɂȂ
+	ChunkLayout GetLayout() const
 	{
-		if(!entity_index_.contains(entity)) _ASSERT_EXPR(FALSE, L"ێĂȂEntity폜悤ƂȂł");
+		ChunkLayout layout{ capacity_, buffer_size_, entity_offset_ };
+		layout.stream_offsets_.reserve(streams_.size());
+		for(const Stream& stream : streams_) layout.stream_offsets_.emplace_back(stream.offset_);
+		for(const ComponentId id : archetype_->component_ids_) layout.enabled_offsets_.emplace_back(columns_[id].enabled_offset_);
+		return layout;
+	}
 
-		const auto it{ entity_index_.find(entity) };
-		const u32 free_index{ it->second };
-		entity_index_.erase(it);
+	// SĂ̗܂ރ̈ World::Saveł̂܂ܕۑ
+	// GetEntityCountsȍ~̍s̃f[^͖`
+	std::span<const u8> GetBuffer() const { return { buffer_, buffer_size_ }; }
 
-		// ԍŌɊ蓖Ăf[^󂢂ƂɈړ
-		// sizecapacityԌindexo
-		const u32 end_index{ size_ - (capacity_ + 1) };
+	// layout̑SĂ̗buffer_size_Ɏ܂Ă邩 World::Loadœǂݍ񂾔zumF̂Ɏgp
+	// EnableableȌ^L/̃rbgAȊOu32̍őlɂȂĂ邱ƂmF
+	// component_ids layoutArchetypeComponentId 
+	static bool IsLayoutInBounds(const ChunkLayout& layout, std::span<const ComponentId> component_ids)
+	{
+		const u64 buffer_size{ layout.buffer_size_ };
+		const u64 capacity{ layout.capacity_ };
+		if(layout.entity_offset_ > buffer_size || capacity * sizeof(Entity) > buffer_size - layout.entity_offset_) return false;
+		if(layout.enabled_offsets_.size() != component_ids.size()) return false;
 
+		u64 stream_index{};
+		for(u64 i = 0; i < component_ids.size(); ++i)
+		{
+			for(const ComponentStream& stream : ComponentTypeRegistry::GetStreams(component_ids[i]))
+			{
+				if(stream_index >= layout.stream_offsets_.size()) return false;
+				const u64 offset{ layout.stream_offsets_[stream_index++] };
+				if(offset > buffer_size || capacity * stream.size_ > buffer_size - offset) return false;
+			}
+
+			const u64 enabled_offset{ layout.enabled_offsets_[i] };
+			if(!ComponentTypeRegistry::IsEnableable(component_ids[i]))
+			{
+				if(enabled_offset != kInvalidIndex) return false;
+				continue;
+			}
+			if(enabled_offset > buffer_size || GetEnabledWordCounts(layout.capacity_) * sizeof(u64) > buffer_size - enabled_offset) return false;
+		}
+		return stream_index == layout.stream_offsets_.size();
+	}
 
-		// index_entity_mapBuffer̍Ō蓖ĂĂEntity擾
-		// EntityIndexRÂĂf[^XV
-		// index_entity_mapŌ̃f[^폜
-		// index_entity_mapfree_indexԖڂentityXV
-		const auto ie_it{ index_entity_map_.find(end_index) };
-		const Entity end_entity{ (*ie_it).second };
-		entity_index_.at(end_entity) = free_index;
-		index_entity_map_.erase(ie_it);
-		index_entity_map_.at(free_index) = end_entity;
+	// ۑChunk̃f[^Entity𕜌 World::LoadŎgp
+	// Entitẙi[ꏊ̍XV͌Ăяoōs SĂ̗̒ǉo[WƕύXo[WXV
+	// src ۑGetBuffer̃f[^ RXgN^bufferɓn̈ł΃Rs[Ȃ
+	// src_layout src̗̔zu ChunkƈقȂꍇ͗񂲂ƂɃRs[
+	// entity_counts srcɊi[ĂEntity̐
+	void RestoreEntities(const u8* src, const ChunkLayout& src_layout, u32 entity_counts)
+	{
+		_ASSERT_EXPR(IsEmpty() && entity_counts <= capacity_, L"ChunkɗeʈȉEntity𕜌Ă");
+		_ASSERT_EXPR(src_layout.stream_offsets_.size() == streams_.size() && src_layout.enabled_offsets_.size() == archetype_->component_ids_.size(), L"قȂArchetypẽf[^ł");
 
-		// comopnent̃f[^ւ
-		for(const auto component_offset : component_offsets_)
+		if(src != buffer_)
 		{
-			const u32 size{ archetype_.component_size_.at(component_offset.first) };
-			const u32 begin_offset_bytes{ component_offset.second };
+			for(u64 i = 0; i < streams_.size(); ++i)
+			{
+				std::memcpy(&buffer_[streams_[i].offset_], &src[src_layout.stream_offsets_[i]], static_cast<u64>(entity_counts) * streams_[i].element_size_);
+			}
+			std::memcpy(&buffer_[entity_offset_], &src[src_layout.entity_offset_], entity_counts * sizeof(Entity));
+			for(u64 i = 0; i < archetype_->component_ids_.size(); ++i)
+			{
+				const u32 enabled_offset{ columns_[archetype_->component_ids_[i]].enabled_offset_ };
+				if(enabled_offset == kInvalidIndex) continue;
+				std::memcpy(&buffer_[enabled_offset], &src[src_layout.enabled_offsets_[i]], GetEnabledWordCounts(entity_counts) * sizeof(u64));
+			}
+		}
+		entity_counts_ = entity_counts;
+		MarkAllAdded();
+	}
 
-			void* new_location{ &buffer_[begin_offset_bytes + size * free_index] };
-			const void* old_location{ &buffer_[begin_offset_bytes + size * end_index] };
+	// buffer_𓯂\[Xmۂ̈Ɉڂ World::CompactŃXu󂯂邽߂Ɏgp
+	// ̔zuƍs̕т͕ςȂ̂ŁAEntitẙi[ꏊƕύXo[W͍XVȂ
+	// grAɃRs[łȂComponent͈ړ̍sɃ[u\zĂړ̍sj ȊO͗񂲂Ƃmemcpy
+	void Relocate()
+	{
+		u8* const src{ buffer_ };
+		buffer_ = static_cast<u8*>(memory_resource_->allocate(buffer_size_, buffer_alignment_));
 
-			std::memcpy(new_location, old_location, size);
+		for(const ComponentId id : archetype_->component_ids_)
+		{
+			const Column& column{ columns_[id] };
+			if(column.enabled_offset_ != kInvalidIndex)
+			{
+				std::memcpy(&buffer_[column.enabled_offset_], &src[column.enabled_offset_], GetEnabledWordCounts(entity_counts_) * sizeof(u64));
+			}
+
+			if(column.lifecycle_.move_construct_)
+			{
+				for(u32 i = 0; i < entity_counts_; ++i)
+				{
+					void* dst_row{ GetRowPointer(id, i) };
+					void* src_row{ src + (static_cast<u8*>(dst_row) - buffer_) };
+					column.lifecycle_.move_construct_(dst_row, src_row);
+					if(column.lifecycle_.destroy_) column.lifecycle_.destroy_(src_row);
+				}
+				continue;
+			}
+
+			for(u32 i = column.stream_begin_; i < column.stream_begin_ + column.stream_counts_; ++i)
+			{
+				std::memcpy(&buffer_[streams_[i].offset_], &src[streams_[i].offset_], static_cast<u64>(entity_counts_) * streams_[i].element_size_);
+			}
 		}
+		std::memcpy(&buffer_[entity_offset_], &src[entity_offset_], entity_counts_ * sizeof(Entity));
 
-		++capacity_;
+		memory_resource_->deallocate(src, buffer_size_, buffer_alignment_);
+	}
+
+	// Chunk̂Ɨ̏̃TCY(oCg) buffer_͊܂܂Ȃ
+	u64 GetOverheadBytes() const { return sizeof(Chunk) + columns_.capacity() * sizeof(Column) + streams_.capacity() * sizeof(Stream); }
+
+	[[nodiscard]] const Archetype& GetArchetype() const { return *archetype_; }
+	u32 GetEntityCounts() const { return entity_counts_; }
+	u32 GetCapacity() const { return capacity_; }
+	u32 GetChunkIndex() const { return chunk_index_; }
+	// ArchetypeStoragerChunkċl߂ƂɍXV
+	void SetChunkIndex(u32 chunk_index) { chunk_index_ = chunk_index; }
+	bool IsFull() const { return entity_counts_ == capacity_; }
+	bool IsEmpty() const { return entity_counts_ == 0; }
+
+	// w肳ꂽComponent̗񂪍Ōɏ݉\ȏԂŎ擾ꂽƂWorld̕ύXo[W
+	// SetComponentDataAconsttȂGetComponentArrayAGetComponentSpanEntity̒ǉړōXV
+	u32 GetChangeVersion(ComponentId id) const
+	{
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		return std::atomic_ref<u32>{ const_cast<u32&>(columns_[id].change_version_) }.load(std::memory_order_relaxed);
 	}
 
-	[[nodiscard]] const Archetype& GetArchetype() const { return archetype_; }
-	u32 GetEntityCounts() const { return size_ - capacity_; }
+	// ChunkɍŌEntityǉꂽƂWorld̕ύXo[W
+	// ChunkPʂȂ̂ŁAComponentǉEntityłȂAArchetypeړĂEntity܂
+	u32 GetAddVersion(ComponentId id) const
+	{
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		return columns_[id].add_version_;
+	}
+
+	// LComponent̒l擾 Chunkׂ̂ĂEntityœlɂȂ
+	// Component ComponentSharedꉻĂComponenť^
+	template<class Component>
+	const Component& GetSharedComponent() const
+	{
+		static_assert(SharedComponent<std::remove_cv_t<Component>>, "ComponentSharedꉻĂȂComponentł");
+
+		const ComponentId id{ GET_COMPONENT_ID(Component) };
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		return *static_cast<const std::remove_cv_t<Component>*>(columns_[id].shared_value_.value_);
+	}
+
+	// LComponent̒l̔ԍ(SharedComponentValue::index_)擾 ԍȂ瓯l
+	u32 GetSharedComponentIndex(ComponentId id) const
+	{
+		_ASSERT_EXPR(HasComponent(id) && columns_[id].shared_value_.value_, L"ێĂȂLComponentw肳܂");
+		return columns_[id].shared_value_.index_;
+	}
+
+	// w肳ꂽsComponentL ComponentEnableableꉻĂȂComponent͏ɗL
+	bool IsComponentEnabled(ComponentId id, u32 index) const
+	{
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		_ASSERT_EXPR(index < entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
+		if(columns_[id].enabled_offset_ == kInvalidIndex) return true;
+
+		const u64 word{ std::atomic_ref<u64>{ GetEnabledWords(id)[index / kEnabledBitsPerWord] }.load(std::memory_order_relaxed) };
+		return (word >> (index % kEnabledBitsPerWord) & 1) != 0;
+	}
+
+	// w肳ꂽsComponent̗L/؂ւ Entity͈ړȂ̂ComponentArrayȂǂ͖ɂȂȂ
+	// [h̕ʂ̍s𕡐̃Xbh瓯ɐ؂ւĂ悢 ̕ύXo[WXV
+	// id ComponentEnableableꉻĂComponent
+	void SetComponentEnabled(ComponentId id, u32 index, bool enabled)
+	{
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		_ASSERT_EXPR(columns_[id].enabled_offset_ != kInvalidIndex, L"ComponentEnableableꉻĂȂComponentł");
+		_ASSERT_EXPR(index < entity_counts_, L"ێĂEntity̐傫Ȓl̃CfbNXo܂");
+
+		std::atomic_ref<u64> word{ GetEnabledWords(id)[index / kEnabledBitsPerWord] };
+		const u64 bit{ 1ull << (index % kEnabledBitsPerWord) };
+		if(enabled) word.fetch_or(bit, std::memory_order_relaxed);
+		else word.fetch_and(~bit, std::memory_order_relaxed);
+		MarkChanged(id);
+	}
+
+	// L/̃rbg擾 isڂ[i / kEnabledBitsPerWord]̉ʂ(i % kEnabledBitsPerWord)Ԗڂ̃rbg
+	// Ō̃[hGetEntityCountsȍ~̃rbg͖`
+	//  : GetComponentArrayƓlɃXR[vł̂ݎgp邱
+	// id ComponentEnableableꉻĂComponent
+	std::span<const u64> GetEnabledBits(ComponentId id) const
+	{
+		_ASSERT_EXPR(HasComponent(id), L"ێĂȂ^w肳܂");
+		_ASSERT_EXPR(columns_[id].enabled_offset_ != kInvalidIndex, L"ComponentEnableableꉻĂȂComponentł");
+		return { std::assume_aligned<kColumnAlignment>(GetEnabledWords(id)), GetEnabledWordCounts(entity_counts_) };
+	}
+
+	// w肳ꂽComponentId̗ێĂ邩
+	bool HasComponent(ComponentId id) const { return id < columns_.size() && columns_[id].stream_begin_ != kInvalidIndex; }
+
 private:
 
-	void Resize(u32 size)
+	// ComponentƂ̗̏
+	struct Column
+	{
+		u32 stream_begin_{ kInvalidIndex };	// streams_̐擪Index ێĂȂꍇkInvalidIndex
+		u32 stream_counts_{};	// AoSȂ1ASoAȂtB[h̗vf̐
+		u32 size_{};			// Component̃TCY
+		u32 change_version_{};	// Ōɏ݉\ȏԂŎ擾ꂽƂWorld̕ύXo[W
+		u32 add_version_{};		// ŌEntityǉꂽƂWorld̕ύXo[W
+		u32 enabled_offset_{ kInvalidIndex };	// L/̃rbgbuffer_̐擪̃ItZbg EnableablełȂꍇkInvalidIndex
+		SharedComponentValue shared_value_{};	// LComponent̒l LComponentłȂꍇvalue_nullptr
+		ComponentLifecycle lifecycle_{};	// grAłȂComponent̍sł̍\zAړAj ComponentTypeRegistry疈Ȃ悤ɕێ
+	};
+
+	// ̕ύXo[WXV
+	// ParallelForeachȂǂŕ̃Xbh瓯lނƂ̂atomic_refʂ
+	void MarkChanged(ComponentId id)
 	{
-		const u32 old_size{ size_ };
-		const u32 new_size{ size };
-		UniquePtr<u8[]> tmp_buffer = std::make_unique<u8[]>(new_size * archetype_.size_);
+		std::atomic_ref<u32>{ columns_[id].change_version_ }.store(*change_version_, std::memory_order_relaxed);
+	}
 
-		// BufferOffsetComponentf[^̍XV
-		for(auto& component_offset : component_offsets_)
+	// Entity̒ǉŃf[^ς̂łׂĂ̗̒ǉo[WƕύXo[WXV
+	void MarkAllAdded()
+	{
+		for(const ComponentId id : archetype_->component_ids_)
 		{
-			const u32 structure_stride{ archetype_.component_size_.at(component_offset.first) };
-			const u32 old_offsets{ component_offset.second };
-			const u32 new_offsets{ component_offset.second / old_size * new_size };
-			const u32 buffer_read_size{ structure_stride * old_size };
+			columns_[id].add_version_ = *change_version_;
+			MarkChanged(id);
+		}
+	}
 
-			std::memcpy(&tmp_buffer[new_offsets], &buffer_[old_offsets], buffer_read_size);
+	// si[łL/̃rbg̃[h
+	static constexpr u32 GetEnabledWordCounts(u32 rows) { return (rows + kEnabledBitsPerWord - 1) / kEnabledBitsPerWord; }
 
-			component_offset.second = new_offsets;
+	u64* GetEnabledWords(ComponentId id) const { return reinterpret_cast<u64*>(&buffer_[columns_[id].enabled_offset_]); }
+
+	// \̕ύXɂ̂ݎgp̂atomicɂȂ
+	void WriteEnabledBit(ComponentId id, u32 index, bool enabled)
+	{
+		u64& word{ GetEnabledWords(id)[index / kEnabledBitsPerWord] };
+		const u64 bit{ 1ull << (index % kEnabledBitsPerWord) };
+		word = enabled ? word | bit : word & ~bit;
+	}
+
+	// ǉꂽ[index, index + counts)̍sׂĂEnableableComponentŗLɂ
+	void EnableRows(u32 index, u32 counts)
+	{
+		for(const ComponentId id : archetype_->component_ids_)
+		{
+			if(columns_[id].enabled_offset_ == kInvalidIndex) continue;
+			for(u32 i = index; i < index + counts; ++i)
+			{
+				WriteEnabledBit(id, i, true);
+			}
 		}
+	}
 
-		size_ = size;
-		capacity_ += new_size - old_size;
-		buffer_.release();
-		buffer_ = std::move(tmp_buffer);
+	// buffer_1̗
+	struct Stream
+	{
+		u32 offset_;		// buffer_̐擪̃ItZbg
+		u32 element_size_;	// 1s̃TCY
+		u32 field_offset_;	// Component̐擪̃ItZbg AoSȂ0
+	};
+
+	// Component̃f[^1sǂݍ SoȀꍇ͊e񂩂W߂
+	void ReadRow(ComponentId id, u32 index, void* dst) const
+	{
+		const Column& column{ columns_[id] };
+		for(u32 i = column.stream_begin_; i < column.stream_begin_ + column.stream_counts_; ++i)
+		{
+			const Stream& stream{ streams_[i] };
+			std::memcpy(static_cast<u8*>(dst) + stream.field_offset_, &buffer_[stream.offset_ + index * stream.element_size_], stream.element_size_);
+		}
 	}
 
-	// Debugp ̃NXw肳ꂽR|[lgێĂ邩mF
-	// ێĂꍇ͉ȂێĂȂꍇ̓AT[go
-	template<class ...Components>
-	void VerifyHolding() const
+	// Component̃f[^1s SoȀꍇ͊eɕ
+	void WriteRow(ComponentId id, u32 index, const void* src)
+	{
+		const Column& column{ columns_[id] };
+		for(u32 i = column.stream_begin_; i < column.stream_begin_ + column.stream_counts_; ++i)
+		{
+			const Stream& stream{ streams_[i] };
+			std::memcpy(&buffer_[stream.offset_ + index * stream.element_size_], static_cast<const u8*>(src) + stream.field_offset_, stream.element_size_);
+		}
+	}
+
+	void CopyStream(const Stream& stream, u32 index, const Chunk& src, const Stream& src_stream, u32 src_index)
 	{
-#ifdef _DEBUG
-		const bool result{ Contains<Components...>() };
-		_ASSERT_EXPR(result, L"ێĂȂComponentw肳܂");
-#endif
+		std::memcpy(&buffer_[stream.offset_ + index * stream.element_size_], &src.buffer_[src_stream.offset_ + src_index * src_stream.element_size_], stream.element_size_);
 	}
 
+	// src̍sComponent̃f[^Chunk̍\zς݂̍sɈڂ ComponentłΗ͓̕
+	// grAɃRs[łȂComponent̓[uAȊO͗񂲂Ƃmemcpy
+	void CopyColumn(ComponentId id, u32 index, Chunk& src, u32 src_index)
+	{
+		const Column& column{ columns_[id] };
+		if(column.lifecycle_.move_assign_)
+		{
+			column.lifecycle_.move_assign_(GetRowPointer(id, index), src.GetRowPointer(id, src_index));
+			return;
+		}
+		CopyStreams(id, index, src, src_index);
+	}
+
+	// src̍sComponent̊eChunk̍smemcpy grAɃRs[łComponent̂
+	void CopyStreams(ComponentId id, u32 index, const Chunk& src, u32 src_index)
+	{
+		const Column& column{ columns_[id] };
+		const Column& src_column{ src.columns_[id] };
+		for(u32 i = 0; i < column.stream_counts_; ++i)
+		{
+			CopyStream(streams_[column.stream_begin_ + i], index, src, src.streams_[src_column.stream_begin_ + i], src_index);
+		}
+	}
+
+	// AoSŊi[ĂComponent̍s̐擪AhX
+	void* GetRowPointer(ComponentId id, u32 index) const
+	{
+		const Column& column{ columns_[id] };
+		return &buffer_[streams_[column.stream_begin_].offset_ + index * column.size_];
+	}
+
+	// Entity̗ɏŖ1sǉ Component̃f[^͍\zȂ
+	u32 AddRow(Entity entity)
+	{
+		_ASSERT_EXPR(!IsFull(), L"eʂςChunkEntityǉȂł");
+
+		const u32 index{ entity_counts_ };
+		std::memcpy(&buffer_[entity_offset_ + index * sizeof(Entity)], &entity, sizeof(Entity));
+		++entity_counts_;
+		MarkAllAdded();
+		EnableRows(index, 1);
+		return index;
+	}
+
+	// ǉsComponentl\z
+	template<class Component>
+	void ConstructComponent(u32 index, Component&& value)
+	{
+		using Type = std::remove_cvref_t<Component>;
+		if constexpr(TagComponent<Type> || SharedComponent<Type>) return;
+		else if constexpr(SoAComponent<Type>) WriteRow(GET_COMPONENT_ID(Type), index, &value);
+		else ::new(GetRowPointer(GET_COMPONENT_ID(Type), index)) Type(std::forward<Component>(value));
+	}
+
+	// [begin, end)̍s̃grAɃRs[łȂComponentj
+	void DestroyRows(u32 begin, u32 end)
+	{
+		for(const ComponentId id : archetype_->component_ids_)
+		{
+			const auto destroy{ columns_[id].lifecycle_.destroy_ };
+			if(!destroy) continue;
+			for(u32 i = begin; i < end; ++i) destroy(GetRowPointer(id, i));
+		}
+	}
+
+	static constexpr u32 AlignOffset(u32 offset, u32 alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+	// Component̗̐擪̃ACg kColumnAlignmentalignof̑傫
+	static u32 GetColumnAlignment(ComponentId id) { return std::max(kColumnAlignment, ComponentTypeRegistry::GetAlignment(id)); }
+
+	static constexpr u32 kInvalidIndex{ std::numeric_limits<u32>::max() };	// ێĂȂComponentColumn::stream_begin_
+
+	const Archetype* archetype_{};	// LArchetypeStorage
+	std::pmr::memory_resource* memory_resource_{};	// buffer_mۂ\[X
+	const u32* change_version_{};	// Worlď݂̕ύXo[W
+	u8* buffer_{};	// ۂɃf[^ێĂ郁̈
+	u32 buffer_size_{};
+	u32 buffer_alignment_{};	// ẽACg̍ől
+	u32 capacity_{};		// oCgł͂Ȃ
+	u32 entity_counts_{};	// ݕێĂEntity̐
+	u32 chunk_index_{};		// ArchetypeStorageł̂Chunk̔ԍ
+	u32 entity_offset_{};	// Entity̗񂪊i[Ăbuffer_̐擪̃ItZbg
+	Vector<Column> columns_{};	// ComponentIdIndexƂeComponent̗̏
+	Vector<Stream> streams_{};	// Component̗ Component̗͘Aĕ
+};
+
+namespace ecs
+{
+	template<class Component>
+	struct Optional;
+}
+
+// ChunkView̃ev[ǧ^߂
+// ecs::Optional<T>̏ꍇTێĂȂChunkłΏۂɂȂȀꍇ̗͋ɂȂ
+template<class Component>
+struct ChunkViewColumn
+{
+	using Type = Component;
+	static constexpr bool kIsOptional{ false };
+};
+
+template<class Component>
+struct ChunkViewColumn<ecs::Optional<Component>>
+{
+	using Type = Component;
+	static constexpr bool kIsOptional{ true };
+};
+
+// ChunkێĂEntity̐AEntity̗Aw肳ꂽComponent̗܂Ƃ߂r[
+// BaseSystem::ForeachChunkœnAŜɑ΂SIMDȂǂł܂Ƃ߂ď邽߂Ɏgp
+// e̐擪Chunk::kColumnAlignmentɑĂāA񓯎mdȂ邱Ƃ͂Ȃ
+//  : Chunk::GetComponentArrayƓlɕێȂ
+// ...Components 擾̌^ consttꍇ͓ǂݍ݂݂̂ƂĈ
+//               ecs::Optional<T>w肵ꍇTێĂȂChunkΏۂɂȂ
+template<class ...Components>
+class ChunkView
+{
+public:
+	static_assert(!IsArgsHasSameType<typename ChunkViewColumn<Components>::Type...>(), "R|[lgw肳Ă܂");
+
 private:
 
-	Archetype archetype_{};
-	UniquePtr<u8[]> buffer_{};	// ۂɃf[^ێĂ郁
-	u32 size_{};		// oCgł͂Ȃ
-	u32 capacity_{};	// oCgł͂Ȃ
-	UnorderedMap<Entity, u32> entity_index_{};	// EntityComponent Array Index ێĂEntityComponentArraŷǂɃf[^Ă邩Index̃}bv
-	UnorderedMap<ComponentId, u32> component_offsets_{};	// eR|[lgi[ĂAhX̃ItZbg//buffer_̐擪̃ItZbg
-	UnorderedMap<u32, Entity> index_entity_map_{};	// 蓖ĂĂIndexEntity肷邽߂map
+	// Components̒constĈv^T Ȃꍇsizeof...(Components)
+	template<class Component>
+	static constexpr u64 IndexOf()
+	{
+		constexpr bool kMatches[]{ std::is_same_v<std::remove_cv_t<typename ChunkViewColumn<Components>::Type>, std::remove_cv_t<Component>>..., false };
+		u64 index{};
+		while(index < sizeof...(Components) && !kMatches[index]) ++index;
+		return index;
+	}
+
+	// ChunkView̃ev[gŎw肵^
+	template<class Component>
+	using Column = ChunkViewColumn<std::tuple_element_t<IndexOf<Component>(), std::tuple<Components..., void>>>;
+
+	// ChunkView̃ev[gŎw肵̌^(const܂)
+	template<class Component>
+	using ColumnType = typename Column<Component>::Type;
+
+public:
+
+	explicit ChunkView(Chunk& chunk) : chunk_(&chunk) {}
+
+	// w肳ꂽComponent̗擾 vfGetEntityCountsƓ
+	// ecs::Optional<T>Ŏw肵ComponentChunkێĂȂꍇ͋ɂȂ
+	// SoAŊi[ĂComponentGetFieldgp邱
+	// Component ChunkView̃ev[gŎw肵^ const͏ȗĂ悢
+	template<class Component>
+	std::span<ColumnType<Component>> Get() const
+	{
+		static_assert(IndexOf<Component>() < sizeof...(Components), "ChunkViewɎw肳ĂȂ^ł");
+		if constexpr(Column<Component>::kIsOptional)
+		{
+			if(!chunk_->HasComponent(GET_COMPONENT_ID(Component))) return {};
+		}
+		return chunk_->GetComponentSpan<ColumnType<Component>>();
+	}
+
+	// SoAŊi[ĂComponent̃tB[h̗擾
+	// float2, float3, float4̃tB[h͗vfƂ̗ɂȂ([0]x, [1]y...) ȊÕtB[h[0]
+	// ecs::Optional<T>Ŏw肵ComponentChunkێĂȂꍇׂ͂ċɂȂ
+	//  const auto position{ view.GetField<&Transform::position_>() };
+	//    for(u32 i = 0; i < view.GetEntityCounts(); ++i) position[0][i] += velocity[0][i];
+	// Field SoALayout::kFieldsɗ񋓂oϐ̃|C^
+	template<auto Field>
+	auto GetField() const
+	{
+		using Component = typename MemberPointerTraits<decltype(Field)>::ClassType;
+		static_assert(IndexOf<Component>() < sizeof...(Components), "ChunkViewɎw肳ĂȂ^ł");
+
+		using FieldSpans = decltype(chunk_->GetFieldSpans<Field, std::is_const_v<ColumnType<Component>>>());
+		if constexpr(Column<Component>::kIsOptional)
+		{
+			if(!chunk_->HasComponent(GET_COMPONENT_ID(Component))) return FieldSpans{};
+		}
+		return chunk_->GetFieldSpans<Field, std::is_const_v<ColumnType<Component>>>();
+	}
+
+	// LComponent̒l擾 Chunkׂ̂ĂEntityœlɂȂ
+	// Component ChunkView̃ev[gconsttĎw肵LComponent Optional͎włȂ
+	template<class Component>
+	const std::remove_cv_t<Component>& GetShared() const
+	{
+		static_assert(IndexOf<Component>() < sizeof...(Components), "ChunkViewɎw肳ĂȂ^ł");
+		static_assert(!Column<Component>::kIsOptional, "OptionalŎw肵LComponent͎擾ł܂");
+		return chunk_->GetSharedComponent<ColumnType<Component>>();
+	}
+
+	// ComponentEnableableꉻĂComponent̗L/̃rbg擾 `Chunk::GetEnabledBitsƓ
+	// ForeachChunk͖ȍs܂߂ČĂяôŁAKvł΂ōsi荞
+	// ecs::Optional<T>Ŏw肵ComponentChunkێĂȂꍇ͋ɂȂ
+	// Component ChunkView̃ev[gŎw肵^ const͏ȗĂ悢
+	template<class Component>
+	std::span<const u64> GetEnabledBits() const
+	{
+		static_assert(IndexOf<Component>() < sizeof...(Components), "ChunkViewɎw肳ĂȂ^ł");
+		static_assert(EnableableComponent<std::remove_cv_t<Component>>, "ComponentEnableableꉻĂȂComponentł");
+		if constexpr(Column<Component>::kIsOptional)
+		{
+			if(!chunk_->HasComponent(GET_COMPONENT_ID(Component))) return {};
+		}
+		return chunk_->GetEnabledBits(GET_COMPONENT_ID(Component));
+	}
+
+	// esEntity Index͊eComponent̗ƑΉĂ
+	std::span<const Entity> GetEntities() const { return chunk_->GetEntities(); }
+
+	// ChunkێĂEntity̐
+	u32 GetEntityCounts() const { return chunk_->GetEntityCounts(); }
+
+private:
+	Chunk* chunk_;
 };
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Chunk̃ubNėp郁\[X
+// Chunk̃TCYȉ̊mۂ͂܂Ƃ߂ĊmۂXuŒTCỸubNƂĐ؂oAꂽubNOSɕԂɎ̊mۂōėp
+// SẴubN󂢂XuReleaseFreeSlabsĂ񂾂Ƃ
+// Entity̑ʂ̒ǉƍ폜JԂĂmalloc/freeȂ
+// ubN傫mہA܂̓ubÑACg傫ACg̊mۂupstreamɂ̂܂ܔC
+// World瓯ɎgpĂ悢
+class ChunkPool : public std::pmr::memory_resource
+{
+public:
+	// 1̃XũTCY(oCg) q[Wy[W1
+	static constexpr u64 kSlabSize{ 2 * 1024 * 1024 };
+
+	// ubN̐擪̃ACg(oCg)
+	static constexpr u64 kBlockAlignment{ 4096 };
+
+	// block_size 1̃ubÑTCY(oCg) kBlockAlignment̔{ɐ؂グ
+	// use_huge_pages truȅꍇALinuxł̓Xuq[Wy[W(MAP_HUGETLB)Ŋmۂ
+	//                mۂłȂꍇ͒ʏ̃y[WŊmۂTransparent Huge Pagesgp悤Ɏw肷(MADV_HUGEPAGE)
+	//                LinuxȊOł͖
+	// upstream XuƃubNɎ܂ȂmۂɎgp郁\[X
+	explicit ChunkPool(u64 block_size, bool use_huge_pages = false, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+		: block_size_((block_size + kBlockAlignment - 1) / kBlockAlignment * kBlockAlignment), use_huge_pages_(use_huge_pages), upstream_(upstream)
+	{
+		_ASSERT_EXPR(block_size > 0, L"0傫lw肵Ă");
+		_ASSERT_EXPR(upstream_, L"upstreamnullptrł");
+	}
+
+	~ChunkPool() override
+	{
+		for(const Slab& slab : slabs_)
+		{
+			FreeSlab(slab);
+		}
+	}
+
+	ChunkPool(const ChunkPool&) = delete;
+	ChunkPool& operator=(const ChunkPool&) = delete;
+	ChunkPool(ChunkPool&&) = delete;
+	ChunkPool& operator=(ChunkPool&&) = delete;
+
+	u64 GetBlockSize() const { return block_size_; }
+
+	// gp
+	struct Stats
+	{
+		u64 slab_counts_{};
+		u64 reserved_bytes_{};	// mۂĂXu̍vTCY
+		u64 free_bytes_{};		// 󂫃ubN̍vTCY
+	};
+
+	Stats GetStats() const
+	{
+		std::lock_guard lock{ mutex_ };
+		Stats ret{ slabs_.size(), 0, (free_blocks_.size() + evacuating_blocks_.size()) * block_size_ };
+		for(const Slab& slab : slabs_) ret.reserved_bytes_ += slab.size_;
+		return ret;
+	}
+
+	// SẴubN󂢂ĂXu
+	// ߂l oCg
+	u64 ReleaseFreeSlabs()
+	{
+		std::lock_guard lock{ mutex_ };
+		const Vector<u64> free_counts{ CountFreeBlocks() };
+
+		Vector<bool> is_released(slabs_.size());
+		for(u64 i = 0; i < slabs_.size(); ++i)
+		{
+			is_released[i] = free_counts[i] == GetBlockCounts(slabs_[i]);
+		}
+		if(std::ranges::none_of(is_released, std::identity{})) return 0;
+
+		const auto in_released_slab = [this, &is_released](const void* block) { return is_released[FindSlab(block)]; };
+		std::erase_if(free_blocks_, in_released_slab);
+		std::erase_if(evacuating_blocks_, in_released_slab);
+
+		u64 ret{};
+		u64 dst{};
+		for(u64 i = 0; i < slabs_.size(); ++i)
+		{
+			if(is_released[i])
+			{
+				if(slabs_[i].is_evacuating_) --evacuating_slab_counts_;
+				ret += slabs_[i].size_;
+				FreeSlab(slabs_[i]);
+			}
+			else
+			{
+				slabs_[dst++] = slabs_[i];
+			}
+		}
+		slabs_.resize(dst);
+		return ret;
+	}
+
+	// gp̃ubNȂXuޔΏۂɑI
+	// ޔΏۂ̃Xu̎gp̃ubNĂяomۂĈڂƁÃXuReleaseFreeSlabsŉł悤ɂȂ
+	// gpȉŁAgp̃ubN𑼂̃Xű󂫃ubNɎ߂XuI
+	// ȍ~̊mۂ͑̃Xu̎gp̃ubN̂gAޔΏۂ̃XũubN͑ɋ󂫂Ȃꍇg
+	// OI񂾑ޔΏۂ͑Iђ
+	// ߂l ޔΏۂ̃Xu̎gp̃ubN̐ 0̏ꍇ͑ޔΏۂ͂Ȃ
+	u64 PrepareEvacuation()
+	{
+		std::lock_guard lock{ mutex_ };
+		free_blocks_.insert(free_blocks_.end(), evacuating_blocks_.begin(), evacuating_blocks_.end());
+		evacuating_blocks_.clear();
+		for(Slab& slab : slabs_) slab.is_evacuating_ = false;
+		evacuating_slab_counts_ = 0;
+
+		const Vector<u64> free_counts{ CountFreeBlocks() };
+		Vector<u64> used_counts(slabs_.size());
+		for(u64 i = 0; i < slabs_.size(); ++i) used_counts[i] = GetBlockCounts(slabs_[i]) - free_counts[i];
+
+		// gp̃ubNȂXuAc̃Xű󂫃ubNɎ܂I
+		Vector<u64> order(slabs_.size());
+		std::iota(order.begin(), order.end(), u64{});
+		std::ranges::stable_sort(order, {}, [&used_counts](u64 i) { return used_counts[i]; });
+
+		u64 spare_counts{ free_blocks_.size() };	// ޔΏۂłȂXű󂫃ubN̐
+		u64 ret{};
+		for(const u64 i : order)
+		{
+			if(used_counts[i] == 0) continue;	// ReleaseFreeSlabsŉ
+			if(used_counts[i] * 2 > GetBlockCounts(slabs_[i]) || ret + used_counts[i] > spare_counts - free_counts[i]) break;
+
+			spare_counts -= free_counts[i];
+			ret += used_counts[i];
+			slabs_[i].is_evacuating_ = true;
+			++evacuating_slab_counts_;
+		}
+		if(ret == 0) return 0;
+
+		// ޔΏۂ̃Xű󂫃ubN𕪂Ac͎gp̃ubNXû̂ɕׂ
+		const auto evacuating_begin{ std::partition(free_blocks_.begin(), free_blocks_.end(), [this](const void* block) { return !slabs_[FindSlab(block)].is_evacuating_; }) };
+		evacuating_blocks_.assign(evacuating_begin, free_blocks_.end());
+		free_blocks_.erase(evacuating_begin, free_blocks_.end());
+		std::ranges::sort(free_blocks_, [this, &used_counts](const void* lhs, const void* rhs)
+		{
+			const u64 lhs_used{ used_counts[FindSlab(lhs)] };
+			const u64 rhs_used{ used_counts[FindSlab(rhs)] };
+			return lhs_used != rhs_used ? lhs_used < rhs_used : std::greater<>{}(lhs, rhs);
+		});
+		return ret;
+	}
+
+	// PrepareEvacuationőޔΏۂɑI񂾃XũubN
+	bool IsEvacuating(const void* block) const
+	{
+		std::lock_guard lock{ mutex_ };
+		return IsEvacuatingBlock(block);
+	}
+
+private:
+
+	struct Slab
+	{
+		void* memory_{};
+		u64 size_{};
+		bool is_mapped_{};		// mmapŊmۂ
+		bool is_evacuating_{};	// PrepareEvacuationőޔΏۂɑI΂ꂽ
+	};
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		if(!IsPoolable(bytes, alignment)) return upstream_->allocate(bytes, alignment);
+
+		std::lock_guard lock{ mutex_ };
+
+		// ޔΏۂ̃XũubN͑ɋ󂫂Ȃꍇg
+		Vector<void*>& blocks{ free_blocks_.empty() && !evacuating_blocks_.empty() ? evacuating_blocks_ : free_blocks_ };
+		if(blocks.empty()) AddSlab();
+
+		void* block{ blocks.back() };
+		blocks.pop_back();
+		return block;
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+	{
+		if(!IsPoolable(bytes, alignment))
+		{
+			upstream_->deallocate(p, bytes, alignment);
+			return;
+		}
+
+		std::lock_guard lock{ mutex_ };
+		(IsEvacuatingBlock(p) ? evacuating_blocks_ : free_blocks_).emplace_back(p);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+	// ubN؂omۂ
+	bool IsPoolable(u64 bytes, u64 alignment) const
+	{
+		return bytes <= block_size_ && alignment <= kBlockAlignment;
+	}
+
+	// Xu1mۂăubNɕA󂫃ubNɒǉ
+	// ubNXu傫ꍇ1ubÑXuɂ
+	void AddSlab()
+	{
+		const Slab slab{ AllocateSlab(std::max(kSlabSize, block_size_)) };
+		slabs_.insert(std::ranges::upper_bound(slabs_, slab.memory_, std::less<>{}, &Slab::memory_), slab);
+
+		u8* begin{ static_cast<u8*>(slab.memory_) };
+		const u64 block_counts{ slab.size_ / block_size_ };
+		free_blocks_.reserve(free_blocks_.size() + block_counts);
+
+		// 납ôŁA擪̃ubNg悤ɋtɐς
+		for(u64 i = block_counts; i > 0; --i)
+		{
+			free_blocks_.emplace_back(begin + (i - 1) * block_size_);
+		}
+	}
+
+	Slab AllocateSlab(u64 size)
+	{
+#ifdef __linux__
+		if(use_huge_pages_)
+		{
+			void* memory{ mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0) };
+			if(memory == MAP_FAILED)
+			{
+				// q[Wy[W\񂳂ĂȂꍇ͒ʏ̃y[WŊmۂTHPɔC
+				memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				_ASSERT_EXPR(memory != MAP_FAILED, L"XůmۂɎs܂");
+				madvise(memory, size, MADV_HUGEPAGE);
+			}
+			return Slab{ memory, size, true, false };
+		}
+#endif
+		return Slab{ upstream_->allocate(size, kBlockAlignment), size, false, false };
+	}
+
+	u64 GetBlockCounts(const Slab& slab) const { return slab.size_ / block_size_; }
+
+	// block܂ރXuslabs_Index XũubNłȂꍇslabs_.size()
+	u64 FindSlab(const void* block) const
+	{
+		const auto it{ std::ranges::upper_bound(slabs_, block, std::less<>{}, &Slab::memory_) };
+		if(it == slabs_.begin()) return slabs_.size();
+
+		const Slab& slab{ *(it - 1) };
+		const bool is_inside{ std::less<>{}(block, static_cast<const u8*>(slab.memory_) + slab.size_) };
+		return is_inside ? static_cast<u64>(it - 1 - slabs_.begin()) : slabs_.size();
+	}
+
+	// XuƂ̋󂫃ubN̐ slabs_Ɠ
+	Vector<u64> CountFreeBlocks() const
+	{
+		Vector<u64> ret(slabs_.size());
+		for(const Vector<void*>* blocks : { &free_blocks_, &evacuating_blocks_ })
+		{
+			for(const void* block : *blocks) ++ret[FindSlab(block)];
+		}
+		return ret;
+	}
+
+	bool IsEvacuatingBlock(const void* block) const
+	{
+		if(evacuating_slab_counts_ == 0) return false;
+
+		const u64 index{ FindSlab(block) };
+		return index < slabs_.size() && slabs_[index].is_evacuating_;
+	}
+
+
+	void FreeSlab(const Slab& slab)
+	{
+#ifdef __linux__
+		if(slab.is_mapped_)
+		{
+			munmap(slab.memory_, slab.size_);
+			return;
+		}
+#endif
+		upstream_->deallocate(slab.memory_, slab.size_, kBlockAlignment);
+	}
+
+private:
+	const u64 block_size_;
+	const bool use_huge_pages_;
+	std::pmr::memory_resource* upstream_;
+
+	mutable std::mutex mutex_{};
+	Vector<Slab> slabs_{};	// AhX̏
+	Vector<void*> free_blocks_{};	// 납oĎg
+	Vector<void*> evacuating_blocks_{};	// ޔΏۂ̃Xű󂫃ubN free_blocks_̏ꍇg
+	u64 evacuating_slab_counts_{};
+};
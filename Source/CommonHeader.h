@@ -1,13 +1,34 @@
 #pragma once
 
+// ECS_NO_DIRECTXMATH`DirectXMathgpAfloat2Ȃǂf[^̍\̂ƂĒ`
+// švZłȂ̂TransformSystem͎gpłȂ(CMakeDirectXMathȂꍇ̃x`}[Np)
+#ifndef ECS_NO_DIRECTXMATH
 #include <DirectXMath.h>
+#endif
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <ranges>
 #include <set>
+#include <span>
+#include <string_view>
+#include <thread>
 #include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
@@ -23,12 +44,51 @@ using s16 = int16_t;
 using s32 = int32_t;
 using s64 = int64_t;
 
+#ifndef ECS_NO_DIRECTXMATH
 using namespace DirectX;
 
 using float2 = XMFLOAT2;
 using float3 = XMFLOAT3;
 using float4 = XMFLOAT4;
 using float4x4 = XMFLOAT4X4;
+#else
+// XMFLOAT2ȂǂƓCAEgƃRXgN^
+struct float2
+{
+	float x, y;
+
+	float2() = default;
+	constexpr float2(float _x, float _y) : x(_x), y(_y) {}
+};
+
+struct float3
+{
+	float x, y, z;
+
+	float3() = default;
+	constexpr float3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+};
+
+struct float4
+{
+	float x, y, z, w;
+
+	float4() = default;
+	constexpr float4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+};
+
+struct float4x4
+{
+	float m[4][4];
+
+	float4x4() = default;
+	constexpr float4x4(float m00, float m01, float m02, float m03,
+					   float m10, float m11, float m12, float m13,
+					   float m20, float m21, float m22, float m23,
+					   float m30, float m31, float m32, float m33)
+		: m{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } } {}
+};
+#endif
 
 template<class T>
 using UniquePtr = std::unique_ptr<T>;
@@ -39,8 +99,8 @@ using SharedPtr = std::shared_ptr<T>;
 template<class T>
 using Vector = std::vector<T>;
 
-template<class Key, class Value>
-using UnorderedMap = std::unordered_map<Key, Value>;
+template<class Key, class Value, class Hash = std::hash<Key>>
+using UnorderedMap = std::unordered_map<Key, Value, Hash>;
 
 template<class T>
 using UnorderedSet = std::unordered_set<T>;
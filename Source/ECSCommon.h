@@ -1,60 +1,462 @@
 #pragma once
 
+#ifdef _WIN32
 #include <Windows.h>
+#else
+// WindowsȊOł_ASSERT_EXPR(crtdbg.h)̑assertŊmF bZ[W̓ChȂ̂ŏo͂Ȃ
+#include <cassert>
+#ifndef _ASSERT_EXPR
+#define _ASSERT_EXPR(expr, message) assert(expr)
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+#endif
 
 
 #include "CommonHeader.h"
-#pragma comment(lib, "rpcrt4.lib")
 
 //using Entity = u32;
-using ComponentId = u64;
+using ComponentId = u32;
 using ArchetypeId = u64;
 
-#define GET_COMPONENT_ID(v) typeid(v).hash_code()
-#define GET_COMPONENT_NAME(v) typeid(v).name()
-#define GENERATE_COMPONENT_ID(v) typeid(v).hash_code()
+// ComponenttB[hƂ̗(SoA)Ŋi[邽߂̓
+// ꉻkFieldsɃoϐ̃|C^ׂė񋓂ƁAChunkComponent̍\̂ł͂ȂtB[hƂɕʁX̗Ŋi[
+// float2, float3, float4̃tB[h͂ɗvf(x, y, z, w)ƂɕʁX̗ɂȂ̂ŁAvfAēǂݍ߂
+// ꉻȂꍇ͍\̂Ƃ1̗Ŋi[(AoS)
+// SoAŊi[ComponentForeachGetComponentArraył͎QƂ擾łȂ̂ŁAForeachChunkChunkView::GetFieldgp
+// 
+// template<>
+// struct SoALayout<Velocity>
+// {
+//     static constexpr auto kFields{ std::make_tuple(&Velocity::linear_, &Velocity::angular_) };
+// };
+template<class Component>
+struct SoALayout {};
 
+// SoALayoutꉻĂComponent
+template<class Component>
+concept SoAComponent = requires { SoALayout<Component>::kFields; };
 
-template<class Head, class ...Tails>
-bool IsArgsHasSameTypeImpl(UnorderedSet<ComponentId>& ids)
+// oϐȂComponent(^O)
+// ArchetypẽVOl`ɂ܂܂AChunkɂ͗Ȃ̂ŃgpȂ
+// 񂪂Ȃ̂Foreacḧɂ͂łȂ i荞݂ɂWith<T>AWithout<T>gp
+template<class Component>
+concept TagComponent = std::is_empty_v<Component>;
+
+// EntityʂArchetypeɈړɗL/؂ւComponentɂ邽߂̓
+// std::true_typepēꉻƁAChunkComponentƂɍs̗L/\rbgێ
+// ɂȂĂsForeachAParallelForeachŌĂяoȂ ^OComponentɂgpł
+// 
+// template<>
+// struct ComponentEnableable<Visible> : std::true_type {};
+template<class Component>
+struct ComponentEnableable : std::false_type {};
+
+// ComponentEnableableꉻĂComponent
+template<class Component>
+concept EnableableComponent = ComponentEnableable<Component>::value;
+
+// lEntityƂł͂ȂChunkƂ1ێComponentɂ邽߂̓
+// std::true_typepēꉻƁAArchetypeEntity͋LComponent̒lƂɕʁXChunkɕĊi[
+// bV}eAȂǑEntityœlɂȂf[^Ɏgp loperator==Ŕr
+// lύXEntity͕ʂChunkɈړ ForeachłconstComponentƂĂ̂ݎ󂯎
+// 
+// template<>
+// struct ComponentShared<Material> : std::true_type {};
+template<class Component>
+struct ComponentShared : std::false_type {};
+
+// ComponentSharedꉻĂComponent
+template<class Component>
+concept SharedComponent = ComponentShared<Component>::value;
+
+// SoAŊi[ƂɃtB[h̃XJ[̗ɕ邩
+// LaneType 1̗̗vf̌^
+// kCounts ̐
+template<class Field>
+struct SoAFieldLanes
+{
+	using LaneType = Field;
+	static constexpr u32 kCounts{ 1 };
+};
+
+template<>
+struct SoAFieldLanes<float2>
+{
+	using LaneType = float;
+	static constexpr u32 kCounts{ 2 };
+};
+
+template<>
+struct SoAFieldLanes<float3>
 {
-	const ComponentId id{ typeid(Head).hash_code() };
-	if(ids.contains(id)) return true;
+	using LaneType = float;
+	static constexpr u32 kCounts{ 3 };
+};
 
-	ids.insert(id);
-	if constexpr(sizeof...(Tails) != 0)
+template<>
+struct SoAFieldLanes<float4>
+{
+	using LaneType = float;
+	static constexpr u32 kCounts{ 4 };
+};
+
+// oϐ̃|C^NXƃǒ^擾
+template<class MemberPointer>
+struct MemberPointerTraits;
+
+template<class Class, class Member>
+struct MemberPointerTraits<Member Class::*>
+{
+	using ClassType = Class;
+	using MemberType = Member;
+};
+
+// ^̖O擾
+// typeid().name()ƈقȂA\[XR[hł΃rhsƂɕςȂ
+// 擪"struct ""class "͎菜̂ŁAOԂ܂߂^ɂȂ  ecs::LocalTransform
+template<class T>
+std::string_view GetTypeName()
+{
+#ifdef _MSC_VER
+	// auto __cdecl GetTypeName<struct ecs::LocalTransform>(void)
+	const std::string_view signature{ __FUNCSIG__ };
+	const u64 begin{ signature.find("GetTypeName<") + std::string_view{ "GetTypeName<" }.size() };
+	std::string_view name{ signature.substr(begin, signature.rfind(">(void)") - begin) };
+#else
+	// std::string_view GetTypeName() [with T = ecs::LocalTransform; std::string_view = ...]
+	const std::string_view signature{ __PRETTY_FUNCTION__ };
+	const u64 begin{ signature.find("T = ") + std::string_view{ "T = " }.size() };
+	std::string_view name{ signature.substr(begin, signature.find_first_of(";]", begin) - begin) };
+#endif
+	for(const std::string_view prefix : { std::string_view{ "struct " }, std::string_view{ "class " }, std::string_view{ "enum " } })
 	{
-		return IsArgsHasSameTypeImpl<Tails...>(ids);
+		if(name.starts_with(prefix)) name.remove_prefix(prefix.size());
 	}
-	return false;
+	return name;
 }
 
-// ϒɓ^܂܂ĂȂmF
-// true ܂܂Ă false ܂܂ĂȂ
-template<class ...Args>
-bool IsArgsHasSameType()
+// Component1̗Component̂ǂi[Ă邩
+// AoS̏ꍇ͍\̑Ŝ1ASoȀꍇ̓tB[h̗vfƂ1
+struct ComponentStream
 {
-	UnorderedSet<ComponentId> ids;
-	return IsArgsHasSameTypeImpl<Args...>(ids);
-}
+	u32 field_offset_;	// Component̐擪̃ItZbg
+	u32 size_;			// 1s̃TCY
+};
+
+// grAłȂComponentChunk̍sň߂̊֐
+// Chunk͍s̃f[^memcpyňړ̂ŁAmemcpyłȂComponent͂ʂč\zAړAj
+// grAȌ^͏svȂ̂nullptrɂȂ ^OƋLComponent͗Ȃ̂ŏnullptr
+struct ComponentLifecycle
+{
+	void (*default_construct_)(void* dst);		// Entity̒ǉɌĂ grAɃftHg\zł^SoǍ^Ȃǂnullptr(f[^͖`̂܂)
+	void (*move_construct_)(void* dst, void* src);	// ʂArchetypeChunk̗̈ւ̈ړɖ\z̍sɌĂ grAɃRs[ł^nullptr
+	void (*copy_construct_)(void* dst, const void* src);	// World::Instantiateł̕ɖ\z̍sɌĂ grAɃRs[ł^nullptr
+	void (*move_assign_)(void* dst, void* src);	// Chunkł̍s̋lߒō\zς݂̍sɌĂ grAɃRs[ł^nullptr
+	void (*destroy_)(void* p);					// Entity̍폜ɌĂ grAɃRs[ł^nullptr
+};
 
-inline std::string CreateUUID()
+// Componenť^Ƃ0AԂID蓖Ă
+// ID͌^Ƃɏ߂ĎgpꂽƂɈx蓖ĂA֐staticϐɃLbV
+// AԂȂ̂ChunkȂǂID̂܂ܔzIndexƂĎgpł
+class ComponentTypeRegistry
 {
-	UUID uuid{};
-	std::string guid{};
+public:
+	struct ComponentInfo
+	{
+		u32 size_;		// Chunk1s̃TCY(sizeof) ^OƋLComponent̏ꍇ0
+		u32 alignment_;	// alignof
+		u32 value_size_;	// sizeof LComponent̒l̕ۑȂǂɎgp
+		String name_;	// ^̖O GetTypeNameō쐬AWorld::Saveŕۑt@C̒Componentʂ̂Ɏgp
+		Vector<ComponentStream> streams_;	// ChunkɊi[Ƃ̗̕ ^OƋLComponent̏ꍇ͋
+		bool is_enableable_;	// ComponentEnableableꉻĂ邩
+		bool is_shared_;		// ComponentSharedꉻĂ邩
+		bool is_trivially_copyable_;	// ̓ê܂ܕۑAł邩
+		ComponentLifecycle lifecycle_;	// Chunk̍sł̍\zAړAj
+	};
 
-	UuidCreate(&uuid);
+	// Componenť^Ɋ蓖ĂꂽID擾
+	// Component ID擾Componenť^
+	template<class Component>
+	static ComponentId GetId()
+	{
+		static const ComponentId id{ Register(ComponentInfo
+		{
+			TagComponent<Component> || SharedComponent<Component> ? 0 : static_cast<u32>(sizeof(Component)),
+			static_cast<u32>(alignof(Component)),
+			static_cast<u32>(sizeof(Component)),
+			String{ GetTypeName<Component>() },
+			CreateStreams<Component>(),
+			EnableableComponent<Component>,
+			SharedComponent<Component>,
+			std::is_trivially_copyable_v<Component>,
+			CreateLifecycle<Component>()
+		}) };
+		return id;
+	}
 
-	RPC_CSTR string_uuid{ nullptr };
-	if(UuidToStringA(&uuid, &string_uuid) == RPC_S_OK)
+	// O(GetTypeName)ComponentId
+	// ߂l ̖Ǒ^܂xGetIdœo^ĂȂꍇstd::nullopt
+	static std::optional<ComponentId> FindId(std::string_view name)
 	{
-		guid = reinterpret_cast<char*>(string_uuid);
-		RpcStringFreeA(&string_uuid);
+		std::lock_guard lock{ mutex_ };
+		const auto it{ std::ranges::find(infos_, name, &ComponentInfo::name_) };
+		if(it == infos_.end()) return std::nullopt;
+		return static_cast<ComponentId>(it - infos_.begin());
 	}
-	return guid;
+
+	static u32 GetSize(ComponentId id) { return GetInfo(id).size_; }
+	static u32 GetAlignment(ComponentId id) { return GetInfo(id).alignment_; }
+	static u32 GetValueSize(ComponentId id) { return GetInfo(id).value_size_; }
+	static const String& GetName(ComponentId id) { return GetInfo(id).name_; }
+	static std::span<const ComponentStream> GetStreams(ComponentId id) { return GetInfo(id).streams_; }
+	static bool IsEnableable(ComponentId id) { return GetInfo(id).is_enableable_; }
+	static bool IsShared(ComponentId id) { return GetInfo(id).is_shared_; }
+	static bool IsTriviallyCopyable(ComponentId id) { return GetInfo(id).is_trivially_copyable_; }
+	static const ComponentLifecycle& GetLifecycle(ComponentId id) { return GetInfo(id).lifecycle_; }
+
+	// SoAŊi[Component̃tB[hԖڂ̗񂩂n܂邩
+	// Field SoALayout::kFieldsɗ񋓂oϐ̃|C^
+	// ߂l kFieldsɗ񋓂ĂȂꍇu32̍ől
+	template<auto Field>
+	static constexpr u32 GetFieldStreamIndex()
+	{
+		using Component = typename MemberPointerTraits<decltype(Field)>::ClassType;
+		static_assert(SoAComponent<Component>, "SoALayoutꉻĂȂComponentł");
+
+		u32 index{};
+		bool found{};
+		std::apply([&index, &found](auto... fields)
+		{
+			([&index, &found](auto field)
+			{
+				if(found) return;
+				if constexpr(std::is_same_v<decltype(field), decltype(Field)>)
+				{
+					if(field == Field)
+					{
+						found = true;
+						return;
+					}
+				}
+				index += SoAFieldLanes<typename MemberPointerTraits<decltype(field)>::MemberType>::kCounts;
+			}(fields), ...);
+		}, SoALayout<Component>::kFields);
+
+		return found ? index : std::numeric_limits<u32>::max();
+	}
+
+	// ݓo^ĂComponenť^̐
+	static u32 GetComponentCounts()
+	{
+		std::lock_guard lock{ mutex_ };
+		return static_cast<u32>(infos_.size());
+	}
+
+private:
+
+	static ComponentId Register(ComponentInfo info)
+	{
+		std::lock_guard lock{ mutex_ };
+		const ComponentId id{ static_cast<ComponentId>(infos_.size()) };
+		infos_.emplace_back(std::move(info));
+		return id;
+	}
+
+	// Component̗̕쐬
+	// SoALayoutꉻĂꍇ̓tB[h̗vfƁAȊO͍\̑Ŝ1̗ɂ ^OƋLComponent͗Ȃ
+	template<class Component>
+	static Vector<ComponentStream> CreateStreams()
+	{
+		if constexpr(TagComponent<Component> || SharedComponent<Component>)
+		{
+			return {};
+		}
+		else if constexpr(!SoAComponent<Component>)
+		{
+			return { ComponentStream{ 0, static_cast<u32>(sizeof(Component)) } };
+		}
+		else
+		{
+			constexpr u64 fields_size{ std::apply([](auto... fields)
+			{
+				return (sizeof(typename MemberPointerTraits<decltype(fields)>::MemberType) + ... + 0);
+			}, SoALayout<Component>::kFields) };
+			static_assert(fields_size == sizeof(Component), "SoALayout::kFieldsɂComponentׂ̂Ẵoϐ񋓂Ă");
+
+			// oϐ̃ItZbg̓IuWFNg炸ɗ̈悾pӂċ߂
+			alignas(Component) static const u8 storage[sizeof(Component)]{};
+			const Component& object{ *reinterpret_cast<const Component*>(storage) };
+
+			Vector<ComponentStream> streams{};
+			std::apply([&streams, &object](auto... fields)
+			{
+				([&streams, &object](auto field)
+				{
+					using Lanes = SoAFieldLanes<typename MemberPointerTraits<decltype(field)>::MemberType>;
+					const u32 field_offset{ static_cast<u32>(reinterpret_cast<const u8*>(&(object.*field)) - storage) };
+					for(u32 i = 0; i < Lanes::kCounts; ++i)
+					{
+						streams.emplace_back(ComponentStream{ field_offset + i * static_cast<u32>(sizeof(typename Lanes::LaneType)), static_cast<u32>(sizeof(typename Lanes::LaneType)) });
+					}
+				}(fields), ...);
+			}, SoALayout<Component>::kFields);
+			return streams;
+		}
+	}
+
+	// Chunk̍sł̍\zAړAj̊֐쐬
+	// SoAŊi[Component͍\̂Ƃč\złȂ̂ŃgrAɃRs[łȂ΂ȂȂ
+	template<class Component>
+	static ComponentLifecycle CreateLifecycle()
+	{
+		ComponentLifecycle lifecycle{};
+		if constexpr(!TagComponent<Component> && !SharedComponent<Component>)
+		{
+			static_assert(!SoAComponent<Component> || std::is_trivially_copyable_v<Component>, "SoAŊi[Component̓grAɃRs[łȂ΂Ȃ܂");
+
+			if constexpr(!SoAComponent<Component> && !std::is_trivially_default_constructible_v<Component>)
+			{
+				if constexpr(std::is_default_constructible_v<Component>)
+				{
+					lifecycle.default_construct_ = [](void* dst) { ::new(dst) Component; };
+				}
+				else if constexpr(!std::is_trivially_copyable_v<Component>)
+				{
+					lifecycle.default_construct_ = [](void*) { _ASSERT_EXPR(FALSE, L"ftHg\złȂComponentł World::AddEntityɒlnĒǉĂ"); };
+				}
+			}
+			if constexpr(!std::is_trivially_copyable_v<Component>)
+			{
+				lifecycle.move_construct_ = [](void* dst, void* src) { ::new(dst) Component(std::move(*static_cast<Component*>(src))); };
+				if constexpr(std::is_copy_constructible_v<Component>)
+				{
+					lifecycle.copy_construct_ = [](void* dst, const void* src) { ::new(dst) Component(*static_cast<const Component*>(src)); };
+				}
+				else
+				{
+					lifecycle.copy_construct_ = [](void*, const void*) { _ASSERT_EXPR(FALSE, L"Rs[łȂComponentEntity͕ł܂"); };
+				}
+				lifecycle.move_assign_ = [](void* dst, void* src) { *static_cast<Component*>(dst) = std::move(*static_cast<Component*>(src)); };
+				lifecycle.destroy_ = [](void* p) { static_cast<Component*>(p)->~Component(); };
+			}
+		}
+		return lifecycle;
+	}
+
+	static const ComponentInfo& GetInfo(ComponentId id)
+	{
+		std::lock_guard lock{ mutex_ };
+		_ASSERT_EXPR(id < infos_.size(), L"o^ĂȂComponentIdw肳܂");
+		return infos_[id];
+	}
+
+private:
+	// Vector̍Ċmۂŗvf̃AhXςȂ悤dequegp
+	inline static std::deque<ComponentInfo> infos_{};
+	inline static std::mutex mutex_{};
+};
+
+// ^Ƃ0AԂID蓖Ă TagƂɓƗAԂɂȂ
+// ^IndexƂĔzɊi[ꍇɎgp(WorldQueryȂ)
+// Tag AԂʂ邽߂̌^
+template<class Tag>
+class TypeIndexRegistry
+{
+public:
+	template<class T>
+	static u32 GetId()
+	{
+		static const u32 id{ counts_.fetch_add(1) };
+		return id;
+	}
+
+private:
+	inline static std::atomic<u32> counts_{};
+};
+
+#define GET_COMPONENT_ID(v) ComponentTypeRegistry::GetId<std::remove_cvref_t<v>>()
+#define GET_COMPONENT_NAME(v) typeid(v).name()
+#define GENERATE_COMPONENT_ID(v) ComponentTypeRegistry::GetId<std::remove_cvref_t<v>>()
+
+
+template<class Head, class ...Tails>
+constexpr bool IsArgsHasSameTypeImpl()
+{
+	if constexpr((std::is_same_v<Head, Tails> || ...)) return true;
+	else if constexpr(sizeof...(Tails) != 0) return IsArgsHasSameTypeImpl<Tails...>();
+	else return false;
 }
 
-inline u64 StringToHash(std::string str)
+// ϒɓ^܂܂ĂȂmF RpCɕ]
+// true ܂܂Ă false ܂܂ĂȂ
+template<class ...Args>
+constexpr bool IsArgsHasSameType()
 {
-	return std::hash<std::string>::_Do_hash(str);
+	if constexpr(sizeof...(Args) == 0) return false;
+	else return IsArgsHasSameTypeImpl<std::remove_cvref_t<Args>...>();
 }
+
+// ^̕тlƂĎ󂯓n߂̋̌^
+template<class ...Types>
+struct TypeList {};
+
+// TypeList1TypeListɂȂ
+template<class ...Lists>
+struct ConcatTypeList
+{
+	using Type = TypeList<>;
+};
+
+template<class ...Types>
+struct ConcatTypeList<TypeList<Types...>>
+{
+	using Type = TypeList<Types...>;
+};
+
+template<class ...Types0, class ...Types1, class ...Rest>
+struct ConcatTypeList<TypeList<Types0...>, TypeList<Types1...>, Rest...> : ConcatTypeList<TypeList<Types0..., Types1...>, Rest...> {};
+
+// TypeListEnableableComponento cvƎQƂ͎菜
+template<class List>
+struct EnableableTypeList;
+
+template<class ...Components>
+struct EnableableTypeList<TypeList<Components...>>
+{
+	using Type = typename ConcatTypeList<std::conditional_t<EnableableComponent<std::remove_cvref_t<Components>>, TypeList<std::remove_cvref_t<Components>>, TypeList<>>...>::Type;
+};
+
+// ֐A֐|C^A֐IuWFNg(_)̈̌^擾
+// Arguments TypeList<̌^...>
+// I[o[[hꂽoperator()ev[goperator()(autoɎ_)͈܂Ȃ̂ŎgpłȂ
+template<class Func>
+struct FunctionTraits : FunctionTraits<decltype(&Func::operator())> {};
+
+template<class Return, class ...Args>
+struct FunctionTraits<Return(Args...)>
+{
+	using Arguments = TypeList<Args...>;
+};
+
+template<class Return, class ...Args>
+struct FunctionTraits<Return(Args...) noexcept> : FunctionTraits<Return(Args...)> {};
+
+template<class Return, class ...Args>
+struct FunctionTraits<Return(*)(Args...)> : FunctionTraits<Return(Args...)> {};
+
+template<class Return, class ...Args>
+struct FunctionTraits<Return(*)(Args...) noexcept> : FunctionTraits<Return(Args...)> {};
+
+template<class Class, class Return, class ...Args>
+struct FunctionTraits<Return(Class::*)(Args...)> : FunctionTraits<Return(Args...)> {};
+
+template<class Class, class Return, class ...Args>
+struct FunctionTraits<Return(Class::*)(Args...) const> : FunctionTraits<Return(Args...)> {};
+
+template<class Class, class Return, class ...Args>
+struct FunctionTraits<Return(Class::*)(Args...) noexcept> : FunctionTraits<Return(Args...)> {};
+
+template<class Class, class Return, class ...Args>
+struct FunctionTraits<Return(Class::*)(Args...) const noexcept> : FunctionTraits<Return(Args...)> {};
@@ -9,9 +9,11 @@ struct Entity
 {
 private:
 	friend class EntityManager;
-	Entity() = default;
 
 public:
+	// Entity z̊mۂȂǂŎgp
+	// EntityManagersEntityȊO͏ɖ
+	Entity() = default;
 
 	bool operator==(const Entity& other) const
 	{
@@ -22,8 +24,8 @@ public:
 	EntityId GetId() const { return id_; }
 
 private:
-	u32 version_;	// EntityVersion idg\̂ŁAŖ{ɓmF
-	EntityId id_;			// Entityid guid ̒lgĂԂ͓l͏oȂ
+	u32 version_{ std::numeric_limits<u32>::max() };	// EntityVersion idg\̂ŁAŖ{ɓmF
+	EntityId id_{ std::numeric_limits<EntityId>::max() };			// Entityid guid ̒lgĂԂ͓l͏oȂ
 };
 namespace std{
     template<>
@@ -32,6 +34,19 @@ namespace std{
     };
 }
 
+class ArchetypeStorage;
+class Chunk;
+
+// Entitỹf[^i[Ăꏊ
+struct EntityLocation
+{
+	ArchetypeStorage* storage_;	// EntityĂArchetypeStorage
+	Chunk* chunk_;				// Entitỹf[^i[ĂChunk
+	u32 index_;					// ChunkIndex
+};
+
+// Entity̔sƁAEntitỹf[^i[Ăꏊ̊Ǘs
+// EntityIdIndexƂzŊǗ̂ŁAEntityEntityLocationւ̃ANZX͔z̎Q1ōς
 class EntityManager
 {
 public:
@@ -42,36 +57,131 @@ public:
 		Entity entity{};
 
 		// ꂽEntityꍇ͂g
+		// Version͉ƂɍXVς
 		if(!free_entities_.empty())
 		{
-			const auto it = free_entities_.begin();
-			entity = (*it);
-			++entity.version_;	//o[W̒ǉ
-			free_entities_.erase(it);
+			entity.id_ = free_entities_.back();
+			free_entities_.pop_back();
 		}
 		else
 		{
-			entity.id_ = entity_counts_;
-			entity.version_ = 0;
-			++entity_counts_;
+			entity.id_ = static_cast<EntityId>(slots_.size());
+			slots_.emplace_back();
 		}
 
-		entity_map_.insert(entity);
+		Slot& slot{ slots_[entity.id_] };
+		slot.location_ = {};
+		entity.version_ = slot.version_;
 		return entity;
 	}
 
+	// Entity܂Ƃ߂č쐬
+	// out 쐬Entity̏ݐ out.size()쐬
+	void CreateEntities(std::span<Entity> out)
+	{
+		const u64 reuse_counts{ std::min<u64>(out.size(), free_entities_.size()) };
+		slots_.reserve(slots_.size() + out.size() - reuse_counts);
+
+		for(Entity& entity : out)
+		{
+			entity = CreateEntity();
+		}
+	}
+
 	void RemoveEntity(Entity entity)
 	{
-		if(!entity_map_.contains(entity)) _ASSERT_EXPR(FALSE, L"Entityw肳܂");
-		const auto it = entity_map_.find(entity);
-		entity_map_.erase(it);
+		if(!IsAlive(entity)) _ASSERT_EXPR(FALSE, L"Entityw肳܂");
+
+		// VersionXVČÂEntity𖳌ɂ
+		Slot& slot{ slots_[entity.id_] };
+		++slot.version_;	//o[W̒ǉ
+		free_entities_.emplace_back(entity.id_);
+	}
+
+	// EntityL(폜ĂȂ)
+	// 폜VersionXVĂ̂ŁAVersionvĂΗL
+	bool IsAlive(Entity entity) const
+	{
+		return entity.id_ < slots_.size() && slots_[entity.id_].version_ == entity.version_;
+	}
+
+	// Entitỹf[^i[Ăꏊ擾
+	// ArchetypeStorageEntityړƂɍXV
+	EntityLocation& GetLocation(Entity entity)
+	{
+		_ASSERT_EXPR(IsAlive(entity), L"Entityw肳܂");
+		return slots_[entity.id_].location_;
+	}
+
+	const EntityLocation& GetLocation(Entity entity) const
+	{
+		_ASSERT_EXPR(IsAlive(entity), L"Entityw肳܂");
+		return slots_[entity.id_].location_;
+	}
+
+	// ݗLEntity̐
+	u32 GetEntityCounts() const { return static_cast<u32>(slots_.size() - free_entities_.size()); }
+
+	// \mۂĂTCY(oCg) 폜EntityidVersionێ邽߂ɎĉŁALEntity̐ł͂Ȃő̐Ō܂
+	u64 GetAllocatedBytes() const { return slots_.capacity() * sizeof(Slot) + free_entities_.capacity() * sizeof(EntityId); }
+
+	// 1Entity\ŎgpTCY(oCg)
+	static constexpr u64 GetSlotSize() { return sizeof(Slot); }
+
+	// EntityIdIndexƂAeidݎgpĂ(ς݂̏ꍇ͎Ɏgp)EntityVersion World::SaveŎgp
+	Vector<u32> GetVersions() const
+	{
+		Vector<u32> ret{};
+		ret.reserve(slots_.size());
+		for(const Slot& slot : slots_) ret.emplace_back(slot.version_);
+		return ret;
+	}
+
+	// ꂽEntityid World::SaveŎgp
+	std::span<const EntityId> GetFreeEntities() const { return free_entities_; }
+
+	// GetVersionsGetFreeEntitiesŕۑԂɖ߂ World::LoadŎgp
+	// i[ꏊ͋ɂȂ̂ŁAEntity𕜌ArchetypeStorageݒ肵
+	void Restore(std::span<const u32> versions, std::span<const EntityId> free_entities)
+	{
+		slots_.assign(versions.size(), Slot{});
+		for(u64 i = 0; i < versions.size(); ++i) slots_[i].version_ = versions[i];
+		free_entities_.assign(free_entities.begin(), free_entities.end());
+	}
 
-		free_entities_.insert(entity);
+	// Restoreɓn\ƁAChunk畜EntityĂȂ World::LoadŕOɊmF
+	// ĂȂidAۑVersionEntityƂĂ傤1񂸂i[Ătrue
+	// versions GetVersionsŕۑVersion
+	// free_entities GetFreeEntitiesŕۑid
+	// entities SĂChunkɊi[ĂEntity
+	static bool IsRestorable(std::span<const u32> versions, std::span<const EntityId> free_entities, std::span<const Entity> entities)
+	{
+		Vector<bool> is_used(versions.size());
+		for(const EntityId id : free_entities)
+		{
+			if(id >= versions.size() || is_used[id]) return false;
+			is_used[id] = true;
+		}
+
+		if(entities.size() != versions.size() - free_entities.size()) return false;
+		for(const Entity entity : entities)
+		{
+			if(entity.id_ >= versions.size() || is_used[entity.id_] || entity.version_ != versions[entity.id_]) return false;
+			is_used[entity.id_] = true;
+		}
+		return true;
 	}
 
 private:
 
-	UnorderedSet<Entity> entity_map_;
-	UnorderedSet<Entity> free_entities_;
-	u32 entity_counts_;
-};
\ No newline at end of file
+	struct Slot
+	{
+		EntityLocation location_{};
+		u32 version_{};		// ݂idgpĂEntityVersion
+	};
+
+private:
+
+	Vector<Slot> slots_{};	// EntityIdIndexƂz
+	Vector<EntityId> free_entities_{};	// ꂽEntityid 납ėp
+};
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+#include "Entity.h"
+#include "World.h"
+
+namespace ecs
+{
+	// Entity̍쐬A폜AComponent̃f[^̃Zbgƍ폜L^ĂAł܂Ƃ߂Ďsobt@
+	// System̎s(Foreach̒Ȃ)Entityǉ폜ComponentArrayɂȂ̂ŁȂɎgp
+	// World::GetEntityCommandBufferŎ擾̂SystemManager::ExecutěWorld܂Ƃ߂Ďs
+	// 1̃obt@𕡐̃Xbh瓯Ɏgp邱Ƃ͂łȂ XbhƂɕʂ̃obt@gp邱
+	class EntityCommandBuffer
+	{
+	public:
+		EntityCommandBuffer() = default;
+		~EntityCommandBuffer() = default;
+
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+		EntityCommandBuffer(EntityCommandBuffer&&) = default;
+		EntityCommandBuffer& operator=(EntityCommandBuffer&&) = default;
+
+		// Entity̍쐬L^
+		// Components̑gݍ킹ŋL^ꂽ͎̂sɂ܂Ƃ߂č쐬
+		// values 쐬EntityComponent̏l
+		template<class ...Components>
+		void CreateEntity(const Components&... values)
+		{
+			GetCommands<CreateEntityCommands<Components...>>(create_commands_).Record(values...);
+		}
+
+		// Entity̍폜L^
+		// sɂłɍ폜ĂEntity͖
+		void DestroyEntity(Entity entity)
+		{
+			destroy_entities_.emplace_back(entity);
+		}
+
+		// Component̃f[^̃ZbgL^
+		// EntityɕL^ꂽꍇ͍ŌɋL^f[^ɂȂ
+		// sɂłɍ폜ĂEntity͖
+		template<class Component>
+		void SetComponentData(Entity entity, const Component& data)
+		{
+			GetCommands<SetComponentDataCommands<Component>>(set_commands_).Record(entity, data);
+		}
+
+		// Component̍폜L^ Entitÿړ1ōς(World::RemoveComponents)
+		// sɂłɍ폜ĂEntityƁAComponentŝꂩێĂȂEntity͖
+		template<class ...Components>
+		void RemoveComponents(Entity entity)
+		{
+			GetCommands<RemoveComponentsCommands<Components...>>(remove_commands_).Record(entity);
+		}
+
+		// L^R}hׂĎsAobt@ɂ
+		// s Component̃f[^̃Zbg  Component̍폜  Entity̍폜  Entity̍쐬
+		// System̎sȂǁAComponentArraygpĂԂ͌Ă΂Ȃ
+		void Playback(World& world)
+		{
+			for(const auto& commands : set_commands_)
+			{
+				if(commands) commands->Playback(world);
+			}
+			for(const auto& commands : remove_commands_)
+			{
+				if(commands) commands->Playback(world);
+			}
+
+			if(!destroy_entities_.empty())
+			{
+				// łɍ폜Ă̂Əd菜Ă܂Ƃ߂č폜
+				std::erase_if(destroy_entities_, [&world](Entity entity) { return !world.IsAlive(entity); });
+				std::ranges::sort(destroy_entities_, {}, &Entity::GetId);
+				const auto [first, last] { std::ranges::unique(destroy_entities_) };
+				destroy_entities_.erase(first, last);
+
+				world.RemoveEntities(destroy_entities_);
+				destroy_entities_.clear();
+			}
+
+			for(const auto& commands : create_commands_)
+			{
+				if(commands) commands->Playback(world);
+			}
+		}
+
+		// L^R}hsɔj
+		void Clear()
+		{
+			for(const auto& commands : set_commands_)
+			{
+				if(commands) commands->Clear();
+			}
+			for(const auto& commands : remove_commands_)
+			{
+				if(commands) commands->Clear();
+			}
+			for(const auto& commands : create_commands_)
+			{
+				if(commands) commands->Clear();
+			}
+			destroy_entities_.clear();
+		}
+
+	private:
+
+		// ^Ƃɂ܂Ƃ߂R}h̊NX
+		// z֐̌Ăяo̓R}h1Ƃł͂Ȃ^Ƃ1񂾂
+		class Commands
+		{
+		public:
+			virtual ~Commands() = default;
+			virtual void Playback(World& world) = 0;
+			virtual void Clear() = 0;
+		};
+
+		// Components̑gݍ킹ō쐬Entity̏l܂Ƃ߂ĕێ
+		template<class ...Components>
+		class CreateEntityCommands : public Commands
+		{
+		public:
+			void Record(const Components&... values)
+			{
+				values_.emplace_back(values...);
+			}
+
+			// L^ꂽ܂Ƃ߂EntityǉAChunk̍sɏl璼ڍ\z
+			// LComponent܂ޏꍇ͒lƂɒǉ悪قȂ̂1ǉ
+			void Playback(World& world) override
+			{
+				if(values_.empty()) return;
+
+				if constexpr((SharedComponent<Components> || ...))
+				{
+					for(std::tuple<Components...>& values : values_)
+					{
+						(void)world.AddEntity(std::move(std::get<Components>(values))...);
+					}
+				}
+				else
+				{
+					const u32 counts{ static_cast<u32>(values_.size()) };
+					entities_.resize(counts);
+
+					u32 value_index{};
+					EntityCommandBuffer::AddEntities<Components...>(world, counts, entities_, [this, &value_index](Chunk& chunk, u32 index, u32 chunk_counts)
+					{
+						for(u32 i = 0; i < chunk_counts; ++i, ++value_index)
+						{
+							const std::tuple<Components...>& values{ values_[value_index] };
+							(chunk.ConstructComponentData<Components>(index + i, 1, std::get<Components>(values)), ...);
+						}
+					});
+				}
+				Clear();
+			}
+
+			void Clear() override { values_.clear(); }
+
+		private:
+			Vector<std::tuple<Components...>> values_{};
+			Vector<Entity> entities_{};	// 쐬Entity̏ݐ mۂȂ悤Ɏg܂킷
+		};
+
+		// Component̃f[^̃Zbg܂Ƃ߂ĕێ
+		template<class Component>
+		class SetComponentDataCommands : public Commands
+		{
+		public:
+			void Record(Entity entity, const Component& data)
+			{
+				commands_.emplace_back(entity, data);
+			}
+
+			void Playback(World& world) override
+			{
+				for(const auto& [entity, data] : commands_)
+				{
+					if(world.IsAlive(entity)) world.SetComponentData<Component>(entity, data);
+				}
+				Clear();
+			}
+
+			void Clear() override { commands_.clear(); }
+
+		private:
+			Vector<std::pair<Entity, Component>> commands_{};	// L^ԂɎs
+		};
+
+		// Components̑gݍ킹̍폜܂Ƃ߂ĕێ
+		template<class ...Components>
+		class RemoveComponentsCommands : public Commands
+		{
+		public:
+			void Record(Entity entity)
+			{
+				entities_.emplace_back(entity);
+			}
+
+			void Playback(World& world) override
+			{
+				for(const Entity entity : entities_)
+				{
+					if(world.IsAlive(entity) && (world.HasComponent<Components>(entity) && ...)) world.RemoveComponents<Components...>(entity);
+				}
+				Clear();
+			}
+
+			void Clear() override { entities_.clear(); }
+
+		private:
+			Vector<Entity> entities_{};	// L^ԂɎs
+		};
+
+		// World::AddEntitiesImplĂԂ߂̒p LComponent܂܂ȂComponentŝ
+		template<class ...Components, class Func>
+		static void AddEntities(World& world, u32 counts, std::span<Entity> out, Func&& func)
+		{
+			world.AddEntitiesImpl<Components...>(counts, out, {}, func);
+		}
+
+		// R}ȟ^ɑΉR}ĥ܂Ƃ܂擾 Ȃꍇ͍쐬
+		template<class T>
+		static T& GetCommands(Vector<UniquePtr<Commands>>& commands)
+		{
+			const u32 id{ TypeIndexRegistry<Commands>::GetId<T>() };
+			if(id >= commands.size()) commands.resize(id + 1);
+
+			UniquePtr<Commands>& ret{ commands[id] };
+			if(!ret) ret = std::make_unique<T>();
+			return static_cast<T&>(*ret);
+		}
+
+	private:
+		Vector<UniquePtr<Commands>> create_commands_{};	// TypeIndexRegistry<Commands>IDIndexƂEntity̍쐬R}h
+		Vector<UniquePtr<Commands>> set_commands_{};	// TypeIndexRegistry<Commands>IDIndexƂComponent̃f[^̃ZbgR}h
+		Vector<UniquePtr<Commands>> remove_commands_{};	// TypeIndexRegistry<Commands>IDIndexƂComponent̍폜R}h
+		Vector<Entity> destroy_entities_{};
+	};
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+
+namespace ecs
+{
+	// [NXeB[ÕXbhv[
+	// [J[XbhƂɃWũL[ÃL[ɂȂ瑼̃[J[̃L[̐擪WuD
+	// ParallelForĂяoXbhWusAׂẴWuI܂Ŗ߂Ȃ
+	class JobSystem
+	{
+	public:
+		// worker_counts 쐬郏[J[Xbh̐ 0̏ꍇParallelForĂяoXbhŎs
+		explicit JobSystem(u32 worker_counts)
+		{
+			queues_ = std::make_unique<WorkQueue[]>(std::max(worker_counts, 1u));
+			queue_counts_ = std::max(worker_counts, 1u);
+
+			workers_.reserve(worker_counts);
+			for(u32 i = 0; i < worker_counts; ++i)
+			{
+				workers_.emplace_back([this, i] { WorkerMain(i); });
+			}
+		}
+
+		~JobSystem()
+		{
+			{
+				std::lock_guard lock{ sleep_mutex_ };
+				stop_ = true;
+			}
+			sleep_condition_.notify_all();
+
+			for(std::thread& worker : workers_)
+			{
+				worker.join();
+			}
+		}
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+
+		// func(index)index = 0 ~ counts - 1 ɂĕɎs
+		// e[J[̃L[ɂ͘Aindex܂Ƃ߂Đς܂̂ŁADȂ͋߂index𓯂Xbhs
+		// ĂяoXbhWusAׂẴWuIĂ߂
+		// counts s
+		// func void(u32 index) ̃Xbh瓯ɌĂ΂
+		template<class Func>
+		void ParallelFor(u32 counts, Func&& func)
+		{
+			if(counts == 0) return;
+
+			// [J[ȂA܂̓Wu1Ȃ炻̏Ŏs
+			if(workers_.empty() || counts == 1)
+			{
+				for(u32 i = 0; i < counts; ++i) func(i);
+				return;
+			}
+
+			std::atomic<u32> remaining_counts{ counts };
+			const JobGroup group
+			{
+				[](void* context, u32 index) { (*static_cast<std::remove_reference_t<Func>*>(context))(index); },
+				const_cast<void*>(static_cast<const void*>(std::addressof(func))),
+				&remaining_counts
+			};
+
+			// [J[̃L[ɘAindexƂɕĐς
+			for(u32 queue_index = 0; queue_index < queue_counts_; ++queue_index)
+			{
+				const u32 begin{ static_cast<u32>(static_cast<u64>(counts) * queue_index / queue_counts_) };
+				const u32 end{ static_cast<u32>(static_cast<u64>(counts) * (queue_index + 1) / queue_counts_) };
+				if(begin == end) continue;
+
+				WorkQueue& queue{ queues_[queue_index] };
+				std::lock_guard lock{ queue.mutex_ };
+				for(u32 i = begin; i < end; ++i)
+				{
+					queue.jobs_.emplace_back(Job{ &group, i });
+				}
+			}
+			queued_counts_.fetch_add(counts);
+			{
+				// ҋ@ɓ낤ƂĂ郏[J[ʒm肱ڂȂ悤ɈxbN
+				std::lock_guard lock{ sleep_mutex_ };
+			}
+			sleep_condition_.notify_all();
+
+			// ĂяoXbhWusȂI҂
+			const u32 start_queue{ current_job_system_ == this ? current_worker_index_ : 0 };
+			while(remaining_counts.load(std::memory_order_acquire) != 0)
+			{
+				if(!TryExecuteJob(start_queue)) std::this_thread::yield();
+			}
+		}
+
+		// [J[Xbh̐
+		u32 GetWorkerCounts() const { return static_cast<u32>(workers_.size()); }
+
+	private:
+
+		// 1ParallelFořĂяoŐς܂ꂽWuLf[^
+		struct JobGroup
+		{
+			void (*invoke_)(void* context, u32 index);
+			void* context_;
+			std::atomic<u32>* remaining_counts_;
+		};
+
+		struct Job
+		{
+			const JobGroup* group_;
+			u32 index_;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex mutex_{};
+			std::deque<Job> jobs_{};
+		};
+
+		void WorkerMain(u32 worker_index)
+		{
+			current_job_system_ = this;
+			current_worker_index_ = worker_index;
+
+			while(true)
+			{
+				if(TryExecuteJob(worker_index)) continue;
+
+				std::unique_lock lock{ sleep_mutex_ };
+				sleep_condition_.wait(lock, [this] { return stop_ || queued_counts_ != 0; });
+				if(stop_ && queued_counts_ == 0) return;
+			}
+		}
+
+		// Wu1oĎs
+		// ̃L[̖oAȂ瑼̃L[̐擪D
+		// start_queue ̃L[̔ԍ
+		// ߂l Wus
+		bool TryExecuteJob(u32 start_queue)
+		{
+			std::optional<Job> job{};
+			for(u32 i = 0; i < queue_counts_ && !job; ++i)
+			{
+				WorkQueue& queue{ queues_[(start_queue + i) % queue_counts_] };
+				std::lock_guard lock{ queue.mutex_ };
+				if(queue.jobs_.empty()) continue;
+
+				if(i == 0)
+				{
+					job = queue.jobs_.back();
+					queue.jobs_.pop_back();
+				}
+				else
+				{
+					job = queue.jobs_.front();
+					queue.jobs_.pop_front();
+				}
+			}
+			if(!job) return false;
+
+			queued_counts_.fetch_sub(1);
+
+			const JobGroup& group{ *job->group_ };
+			group.invoke_(group.context_, job->index_);
+			group.remaining_counts_->fetch_sub(1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		Vector<std::thread> workers_{};
+		UniquePtr<WorkQueue[]> queues_{};	// [J[Ƃ̃L[
+		u32 queue_counts_{};
+
+		std::mutex sleep_mutex_{};
+		std::condition_variable sleep_condition_{};
+		std::atomic<u64> queued_counts_{};	// L[ɐς܂ĂĂ܂oĂȂWu̐
+		bool stop_{};
+
+		inline static thread_local const JobSystem* current_job_system_{};	// ̃Xbh[J[ƂďĂJobSystem
+		inline static thread_local u32 current_worker_index_{};
+	};
+}
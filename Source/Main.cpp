@@ -4,8 +4,8 @@
 #include "Archetype.h"
 #include "Chunk.h"
 #include "World.h"
-#include "PerformanceCounter.h"
 #include "System.h"
+#include "TransformSystem.h"
 
 constexpr float kFactor{ 1.0f };
 constexpr int kNumObjects{ 200 };
@@ -72,7 +72,8 @@ public:
 
 	void Execute() override
 	{
-		Foreach<Transform>(&Update);
+		// O̎sTransformύXĂȂChunk̓[hsvZȂ
+		Foreach<ecs::Changed<Transform>>(&Update);
 	}
 
 private:
@@ -84,14 +85,15 @@ public:
 	UpdateCamera() = default;
 
 	inline static int i = 0;
-	static void Update(Transform& t, Camera& c)
+	static void Update(const Transform& t, Camera& c)
 	{
 		c.focus_ = float3(i, i, i);
 		++i;
 	}
 	void Execute() override
 	{
-		Foreach<Transform, Camera>(&Update);
+		// Transform͓ǂݍ݂Ȃ̂ŁATransformǂݍޑSystemƕɎsł
+		Foreach(&Update);
 	}
 };
 int main()
@@ -109,25 +111,37 @@ int main()
 
 	for(int i = 0; i < kNumObjects; ++i)
 	{
+		t.position_.x = kFactor * i;
+		t.position_.y = kFactor * i;
+		t.position_.z = kFactor * i;
+
+		// lnĒǉƁAǉsɒڏ܂
 		if(i % 3 == 0)
 		{
-			entities.emplace_back(world.AddEntity<Transform>());
+			entities.emplace_back(world.AddEntity(t));
 		}
 		else if(i % 3 == 1)
 		{
-			entities.emplace_back(world.AddEntity<Transform, Camera>());
+			entities.emplace_back(world.AddEntity(t, Camera{}));
 		}
 		else
 		{
-			entities.emplace_back(world.AddEntity<Transform, Camera, DirectionLight>());
+			entities.emplace_back(world.AddEntity(t, Camera{}, DirectionLight{}));
 		}
-		t.position_.x = kFactor * i;
-		t.position_.y = kFactor * i;
-		t.position_.z = kFactor * i;
-		world.SetComponentData(entities.at(i), t);
 	}
 
-	world.GetSystemManager()->AddSystems<UpdateTransform, UpdateCamera>();
+	// eq֌W q̃[hs͐ẽ[hs|ČvZ
+	ecs::LocalTransform local{};
+	local.position_ = float3(10.0f, 0.0f, 0.0f);
+	const Entity root{ world.AddEntity(local, ecs::LocalToWorld{}) };
+	for(int i = 0; i < 4; ++i)
+	{
+		local.position_ = float3(0.0f, kFactor * i, 0.0f);
+		const Entity child{ world.AddEntity(local, ecs::LocalToWorld{}) };
+		ecs::SetParent(world, child, root);
+	}
+
+	world.GetSystemManager()->AddSystems<UpdateTransform, UpdateCamera, ecs::TransformSystem>();
 	//world.AddSystems<UpdateTransform>();
 
 	world.ExecuteSystems();
@@ -1,16 +1,18 @@
 #pragma once
 
-#include <Windows.h>
+#include <chrono>
 #include "CommonHeader.h"
 
+// Ԃ̌oߎԂv
+// std::chrono::steady_clockgp̂WindowsȊOłgpł(MSVCłQueryPerformanceCounterƓx)
 class PerformanceCounter
 {
 public:
 
+    // vJn
+    // ߂l Endɓnԍ EndĂԂ܂ő̌vɂ͎gȂ
     inline static u32 Begin()
     {
-        if(cpu_frequency_.QuadPart == 0) QueryPerformanceFrequency(&cpu_frequency_);
-
 	    u32 ret{};
         if(!free_indices_.empty())
         {
@@ -19,28 +21,27 @@ public:
         }
         else
         {
-	        ret = count_begin_.size();
+	        ret = static_cast<u32>(count_begin_.size());
             count_begin_.emplace_back();
         }
 
-        LARGE_INTEGER count_begin{};
-        QueryPerformanceCounter(&count_begin);
-        count_begin_.at(ret) = count_begin;
+        count_begin_.at(ret) = Clock::now();
         return ret;
     }
 
-   inline  static double End(u32 clock_index)
+    // vIABegiňoߎ(~b)Ԃ ԍ͍ėpł悤ɕԋp
+    inline static double End(u32 clock_index)
     {
-        LARGE_INTEGER count_end{};
-        QueryPerformanceCounter(&count_end);
-
-        const LARGE_INTEGER count_begin{ count_begin_.at(clock_index) };
+        const Clock::time_point count_end{ Clock::now() };
+        const Clock::time_point count_begin{ count_begin_.at(clock_index) };
+        free_indices_.emplace_back(clock_index);
 
-        return  1000.0 * (static_cast<double>(count_end.QuadPart - count_begin.QuadPart) / static_cast<double>(cpu_frequency_.QuadPart));
+        return std::chrono::duration<double, std::milli>(count_end - count_begin).count();
     }
 
 private:
-    inline static LARGE_INTEGER cpu_frequency_{ 0 };
-    inline static Vector<LARGE_INTEGER> count_begin_{};
+    using Clock = std::chrono::steady_clock;
+
+    inline static Vector<Clock::time_point> count_begin_{};
     inline static Vector<u32> free_indices_{};
-};
\ No newline at end of file
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+
+// 0`SystemƂ̌vɊւR[hׂĎ菜 WorldSystemProfilerێASystemvp̃oȂ
+#ifndef ECS_PROFILER_ENABLED
+#define ECS_PROFILER_ENABLED 1
+#endif
+
+namespace ecs
+{
+	inline constexpr bool kProfilerEnabled{ ECS_PROFILER_ENABLED != 0 };
+
+	// System1̎sŏ Foreachn̊֐ΏۂChunkƂɉZ
+	struct SystemProfileCounts
+	{
+		u64 bytes_{};			// Entity̐~Component1s̃TCY Optional̈͊܂܂Ȃ
+		u32 chunk_counts_{};
+		u32 entity_counts_{};
+	};
+
+	// System1̎s̋L^
+	struct SystemProfileEvent
+	{
+		u64 frame_;				// SystemManager::Executẻڂ̎s 1n܂
+		u64 begin_;				// SystemProfiler̍쐬̌oߎ(imb)
+		u64 end_;
+		SystemProfileCounts counts_;
+		u32 system_id_;			// SystemProfiler::AddSystem̖߂l t[Ŝ̏ꍇkFrameId
+	};
+
+	// ߂̃t[łSystem̎sԂƏʂ̏Wv
+	struct SystemProfileSummary
+	{
+		String name_{};
+		u32 samples_{};			// Wvs̉
+		double min_ms_{};
+		double avg_ms_{};
+		double p99_ms_{};
+		double avg_chunk_counts_{};
+		double avg_entity_counts_{};
+		double avg_bytes_{};
+	};
+
+	// SystemƂ̎sԂƏʂL^
+	// L^͎sXbhp̃Oobt@ɏނ̂ŁASystemɎsĂbNȂ
+	// obt@tɂȂƌÂL^㏑
+	// WvƏo͂System̎sɌĂ΂Ȃ
+	class SystemProfiler
+	{
+	public:
+		static constexpr u32 kEventCapacity{ 4096 };	// XbhƂɕێL^̐
+		static constexpr u32 kFrameId{ std::numeric_limits<u32>::max() };
+		static constexpr u32 kDefaultSummaryFrames{ 120 };
+
+		// serial_number XbhƂ̃obt@WorldƂɋʂ邽߂̔ԍ
+		explicit SystemProfiler(u64 serial_number) : serial_number_(serial_number) {}
+
+		SystemProfiler(const SystemProfiler&) = delete;
+		SystemProfiler& operator=(const SystemProfiler&) = delete;
+
+		// L^Systemo^ ߂l Recordɓnԍ
+		u32 AddSystem(std::string_view name)
+		{
+			names_.emplace_back(name);
+			return static_cast<u32>(names_.size()) - 1;
+		}
+
+		// 쐬̌oߎ(imb)
+		u64 Now() const
+		{
+			return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin_).count());
+		}
+
+		// SystemManager::Execute̍ŏɌĂ΂ ߂l EndFrameɓnJn
+		u64 BeginFrame()
+		{
+			frame_.fetch_add(1, std::memory_order_relaxed);
+			return Now();
+		}
+
+		void EndFrame(u64 begin) { Record(kFrameId, begin, Now(), {}); }
+
+		// s̃Xbh̃obt@ɋL^
+		void Record(u32 system_id, u64 begin, u64 end, const SystemProfileCounts& counts)
+		{
+			ThreadBuffer& buffer{ GetThreadBuffer() };
+			const u64 index{ buffer.write_counts_.load(std::memory_order_relaxed) };
+			buffer.events_[index % kEventCapacity] = { frame_.load(std::memory_order_relaxed), begin, end, counts, system_id };
+			buffer.write_counts_.store(index + 1, std::memory_order_release);
+		}
+
+		// ݂̃t[ xsĂȂꍇ0
+		u64 GetFrame() const { return frame_.load(std::memory_order_relaxed); }
+
+		// frame_countst[SystemƂ̏Wv xL^ĂȂSystem͊܂܂Ȃ
+		Vector<SystemProfileSummary> GetSummaries(u32 frame_counts = kDefaultSummaryFrames) const
+		{
+			const u64 frame{ GetFrame() };
+			const u64 first_frame{ frame > frame_counts ? frame - frame_counts + 1 : 1 };
+
+			Vector<Vector<const SystemProfileEvent*>> system_events(names_.size());
+			ForeachEvent([&](const SystemProfileEvent& event, u32)
+			{
+				if(event.system_id_ < system_events.size() && event.frame_ >= first_frame) system_events[event.system_id_].emplace_back(&event);
+			});
+
+			Vector<SystemProfileSummary> ret{};
+			Vector<u64> durations{};
+			for(u32 id = 0; id < system_events.size(); ++id)
+			{
+				const Vector<const SystemProfileEvent*>& events{ system_events[id] };
+				if(events.empty()) continue;
+
+				durations.clear();
+				SystemProfileSummary& summary{ ret.emplace_back(SystemProfileSummary{ .name_ = names_[id], .samples_ = static_cast<u32>(events.size()) }) };
+				for(const SystemProfileEvent* event : events)
+				{
+					durations.emplace_back(event->end_ - event->begin_);
+					summary.avg_chunk_counts_ += event->counts_.chunk_counts_;
+					summary.avg_entity_counts_ += event->counts_.entity_counts_;
+					summary.avg_bytes_ += static_cast<double>(event->counts_.bytes_);
+				}
+				std::ranges::sort(durations);
+
+				constexpr double kNanosecondsPerMillisecond{ 1000000.0 };
+				const double samples{ static_cast<double>(summary.samples_) };
+				const u64 p99_index{ (durations.size() * 99 + 99) / 100 - 1 };	// ؂グʂ̗vf
+				summary.min_ms_ = static_cast<double>(durations.front()) / kNanosecondsPerMillisecond;
+				summary.avg_ms_ = static_cast<double>(std::accumulate(durations.begin(), durations.end(), u64{})) / samples / kNanosecondsPerMillisecond;
+				summary.p99_ms_ = static_cast<double>(durations[p99_index]) / kNanosecondsPerMillisecond;
+				summary.avg_chunk_counts_ /= samples;
+				summary.avg_entity_counts_ /= samples;
+				summary.avg_bytes_ /= samples;
+			}
+			return ret;
+		}
+
+		// obt@ɎcĂL^Chromẽg[XCxg`(JSON)ŏ
+		// chrome://tracing  Perfetto œǂݍ߂ tid̓obt@쐬
+		void WriteChromeTrace(std::ostream& stream) const
+		{
+			stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+			bool is_first{ true };
+			const auto separate = [&stream, &is_first]()
+			{
+				if(!is_first) stream << ",";
+				stream << "\n";
+				is_first = false;
+			};
+
+			for(u32 i = 0; i < buffers_.size(); ++i)
+			{
+				separate();
+				stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\"Thread " << i << "\"}}";
+			}
+
+			const std::ios::fmtflags flags{ stream.flags() };
+			const std::streamsize precision{ stream.precision() };
+			stream << std::fixed << std::setprecision(3);
+			ForeachEvent([&](const SystemProfileEvent& event, u32 thread_index)
+			{
+				separate();
+				stream << "{\"name\":\"";
+				if(event.system_id_ == kFrameId) stream << "Frame";
+				else WriteEscaped(stream, event.system_id_ < names_.size() ? names_[event.system_id_] : String{});
+				stream << "\",\"cat\":\"" << (event.system_id_ == kFrameId ? "frame" : "system") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread_index
+					<< ",\"ts\":" << static_cast<double>(event.begin_) / 1000.0 << ",\"dur\":" << static_cast<double>(event.end_ - event.begin_) / 1000.0
+					<< ",\"args\":{\"frame\":" << event.frame_ << ",\"chunks\":" << event.counts_.chunk_counts_
+					<< ",\"entities\":" << event.counts_.entity_counts_ << ",\"bytes\":" << event.counts_.bytes_ << "}}";
+			});
+			stream.flags(flags);
+			stream.precision(precision);
+
+			stream << "\n]}\n";
+		}
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct ThreadBuffer
+		{
+			std::array<SystemProfileEvent, kEventCapacity> events_{};
+			std::atomic<u64> write_counts_{};	// ܂łɋL^ kEventCapacity𒴂͏㏑Ă
+		};
+
+		ThreadBuffer& GetThreadBuffer()
+		{
+			// serial_number_L[ƂXbhƂ̃obt@
+			thread_local UnorderedMap<u64, ThreadBuffer*> buffers{};
+
+			if(const auto it{ buffers.find(serial_number_) }; it != buffers.end()) return *it->second;
+
+			std::lock_guard lock{ buffer_mutex_ };
+			ThreadBuffer* buffer{ buffers_.emplace_back(std::make_unique<ThreadBuffer>()).get() };
+			buffers.insert({ serial_number_, buffer });
+			return *buffer;
+		}
+
+		// obt@ɎcĂL^ÂɌĂяo
+		// func void(const SystemProfileEvent&, u32 thread_index)
+		template<class Func>
+		void ForeachEvent(Func&& func) const
+		{
+			std::lock_guard lock{ buffer_mutex_ };
+			for(u32 i = 0; i < buffers_.size(); ++i)
+			{
+				const ThreadBuffer& buffer{ *buffers_[i] };
+				const u64 end{ buffer.write_counts_.load(std::memory_order_acquire) };
+				for(u64 j = end > kEventCapacity ? end - kEventCapacity : 0; j < end; ++j)
+				{
+					func(buffer.events_[j % kEventCapacity], i);
+				}
+			}
+		}
+
+		static void WriteEscaped(std::ostream& stream, std::string_view str)
+		{
+			for(const char c : str)
+			{
+				if(c == '"' || c == '\\') stream << '\\' << c;
+				else if(static_cast<unsigned char>(c) < 0x20) stream << ' ';
+				else stream << c;
+			}
+		}
+
+	private:
+		const u64 serial_number_;
+		const Clock::time_point origin_{ Clock::now() };
+		std::atomic<u64> frame_{};
+		Vector<String> names_{};						// AddSystem̖߂l̏
+		Vector<UniquePtr<ThreadBuffer>> buffers_{};	// GetThreadBufferŃXbhƂɍ쐬obt@
+		mutable std::mutex buffer_mutex_{};			// buffers_ւ̒ǉƓǂݍ݂Ŏgp
+	};
+}
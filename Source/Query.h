@@ -0,0 +1,247 @@
+#pragma once
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+#include "Archetype.h"
+#include "ArchetypeStorage.h"
+
+namespace ecs
+{
+	// ɈvArchetypeStoragẽXgێNX
+	// WorldɐVArchetypeStorageǉ邽тɏmFăXgXV̂
+	// t[̌⃁mۂ͔Ȃ
+	class QueryBase
+	{
+		friend class World;
+	public:
+		virtual ~QueryBase() = default;
+
+		QueryBase(const QueryBase&) = delete;
+		QueryBase& operator=(const QueryBase&) = delete;
+
+		// ɈvArchetypeStoragẽXg擾
+		// ArchetypeStorageWorldj܂ŉȂ̂ŕێĂȂ
+		[[nodiscard]] const Vector<ArchetypeStorage*>& GetArchetypeStorages() const { return archetype_storages_; }
+
+		// ɈvArchetypeStoragȇSChunkɑ΂Ċ֐Ăяo
+		// EntityێĂȂChunk͌ĂяoȂ
+		// func void(Chunk&)
+		template<class Func>
+		void ForeachChunk(Func&& func) const
+		{
+			for(ArchetypeStorage* storage : archetype_storages_)
+			{
+				for(const auto& chunk : storage->GetChunks())
+				{
+					if(!chunk->IsEmpty()) func(*chunk);
+				}
+			}
+		}
+
+		// ɈvEntity̍v
+		u32 GetEntityCounts() const
+		{
+			u32 ret{};
+			for(const ArchetypeStorage* storage : archetype_storages_) ret += storage->GetEntityCounts();
+			return ret;
+		}
+
+	protected:
+
+		// required_ids ɕ񂾕ێĂȂ΂ȂComponentId
+		// excluded_ids ɕ񂾕ێĂĂ͂ȂComponentId
+		// any_ids_list ɕComponentId̃Xg ꂼ̃Xg班ȂƂ1ێĂȂ΂Ȃ
+		QueryBase(std::span<const ComponentId> required_ids, std::span<const ComponentId> excluded_ids, Vector<std::span<const ComponentId>> any_ids_list)
+			: required_ids_(required_ids), excluded_ids_(excluded_ids), any_ids_list_(std::move(any_ids_list)) {}
+
+	private:
+
+		// WorldɐVArchetypeStorageǉꂽƂɌĂ΂
+		// Ɉvꍇ̂݃Xgɒǉ
+		void AddArchetypeStorage(ArchetypeStorage* storage)
+		{
+			if(IsMatch(storage->GetArchetype())) archetype_storages_.emplace_back(storage);
+		}
+
+		// Ɉv邩
+		// ArchetypeƂɈx肷̂ŁAChunk̑ɂ͏̊mF͔Ȃ
+		// ǂɕł̂Ő`̔rŊmFł
+		bool IsMatch(const Archetype& archetype) const
+		{
+			const std::span<const ComponentId> component_ids{ archetype.GetComponentIds() };
+			if(!std::ranges::includes(component_ids, required_ids_)) return false;
+			if(HasIntersection(component_ids, excluded_ids_)) return false;
+			return std::ranges::all_of(any_ids_list_, [&](std::span<const ComponentId> any_ids) { return HasIntersection(component_ids, any_ids); });
+		}
+
+		// ɕ2̃XgɋʂComponentId邩
+		static bool HasIntersection(std::span<const ComponentId> lhs, std::span<const ComponentId> rhs)
+		{
+			auto l{ lhs.begin() };
+			auto r{ rhs.begin() };
+			while(l != lhs.end() && r != rhs.end())
+			{
+				if(*l == *r) return true;
+				if(*l < *r) ++l;
+				else ++r;
+			}
+			return false;
+		}
+
+	private:
+		// ǂArchetype::GetSortedComponentIdsLbVĂzQƂ
+		std::span<const ComponentId> required_ids_{};
+		std::span<const ComponentId> excluded_ids_{};
+		Vector<std::span<const ComponentId>> any_ids_list_{};
+		Vector<ArchetypeStorage*> archetype_storages_{};
+	};
+
+	// Query̏ ComponentsׂĕێĂArchetypeΏۂɂ
+	// Component̗͎擾Ȃ̂ŁAANZXƂĂ͋L^Ȃ
+	template<class ...Components>
+	struct With {};
+
+	// Query̏ ComponentsǂێĂȂArchetypeΏۂɂ
+	template<class ...Components>
+	struct Without {};
+
+	// Query̏ ComponentŝȂƂ1ێĂArchetypeΏۂɂ
+	template<class ...Components>
+	struct Any {};
+
+	// Query̏ ComponentێĂȂArchetypeΏۂɂ
+	// ێĂȂChunkł́AForeach̃|C^ɂnullptrAChunkView̗ɂ͋spann
+	template<class Component>
+	struct Optional {};
+
+	// vnu̖ڈɂȂ^OComponent World::Instantiateŕ錳Entityɒǉ
+	// PrefabێĂEntitýAQuery̏Prefab܂߂Ȃ(PrefabAWith<Prefab>AAny<Prefab, ...>AOptional<Prefab>)ΏۂɂȂȂ̂
+	// SystemɏꂸɏlێĂ EntityɂPrefab͊܂܂Ȃ
+	//  const Entity prefab{ world.AddEntity(Bullet{ 10.0f }, LocalTransform{}, LocalToWorld{}, Prefab{}) };
+	//    world.Instantiate(prefab, 1000, bullets);
+	struct Prefab {};
+
+	// Foreach̃tB^ OSystemsĂComponent̗񂪏݉\ȏԂŎ擾ꂽChunkΏۂɂ
+	// ChunkPʂȂ̂ŁAChunk̑EntityύXꂽꍇΏۂɂȂ
+	// Component ChunkێĂȂ΂ȂComponent ǂݍ݂ƂĈ
+	template<class Component>
+	struct Changed {};
+
+	// Foreach̃tB^ OSystemsĂEntityǉꂽChunkΏۂɂ
+	// ArchetypëړChunkɓĂEntity܂
+	// Component ChunkێĂȂ΂ȂComponent ǂݍ݂ƂĈ
+	template<class Component>
+	struct Added {};
+
+	// ύXo[Wlast_versionV
+	// ύXo[W͈\̂ō̕Ŕ肷 last_version0(xsĂȂ)̏ꍇ͏ɐV
+	inline bool IsNewerVersion(u32 version, u32 last_version)
+	{
+		return last_version == 0 || static_cast<s32>(version - last_version) > 0;
+	}
+
+	// Query̏(Component, With, Without, Any, Optional, Changed, Added)̓e
+	// Required ێĂȂ΂ȂComponent
+	// Excluded ێĂĂ͂ȂComponent
+	// AnyGroups ȂƂ1ێĂȂ΂ȂComponent̃Xg̕
+	// Read 擾Ȃǂݍ݂ƂĈComponent
+	// kMentionsPrefab PrefabɂĂ̏ falsȅꍇPrefabێĂArchetypeO
+	// IsMatch Chunk𖞂 last_version OSystemsƂ̕ύXo[W
+	template<class Term>
+	struct QueryTermTraits
+	{
+		using Required = TypeList<Term>;
+		using Excluded = TypeList<>;
+		using AnyGroups = TypeList<>;
+		using Read = TypeList<>;
+		static constexpr bool kMentionsPrefab{ std::is_same_v<std::remove_cv_t<Term>, Prefab> };
+		static bool IsMatch(const Chunk&, u32) { return true; }
+	};
+
+	template<class ...Components>
+	struct QueryTermTraits<With<Components...>> : QueryTermTraits<TypeList<>>
+	{
+		using Required = TypeList<Components...>;
+		static constexpr bool kMentionsPrefab{ (std::is_same_v<Components, Prefab> || ...) };
+	};
+
+	template<class ...Components>
+	struct QueryTermTraits<Without<Components...>> : QueryTermTraits<TypeList<>>
+	{
+		using Required = TypeList<>;
+		using Excluded = TypeList<Components...>;
+		static constexpr bool kMentionsPrefab{ (std::is_same_v<Components, Prefab> || ...) };
+	};
+
+	template<class ...Components>
+	struct QueryTermTraits<Any<Components...>> : QueryTermTraits<TypeList<>>
+	{
+		static_assert(sizeof...(Components) > 0, "Anyɂ1ȏComponentw肵Ă");
+		using Required = TypeList<>;
+		using AnyGroups = TypeList<TypeList<Components...>>;
+		static constexpr bool kMentionsPrefab{ (std::is_same_v<Components, Prefab> || ...) };
+	};
+
+	template<class Component>
+	struct QueryTermTraits<Optional<Component>> : QueryTermTraits<TypeList<>>
+	{
+		using Required = TypeList<>;
+		static constexpr bool kMentionsPrefab{ std::is_same_v<Component, Prefab> };
+	};
+
+	template<class Component>
+	struct QueryTermTraits<Changed<Component>> : QueryTermTraits<TypeList<>>
+	{
+		using Required = TypeList<Component>;
+		using Read = TypeList<Component>;
+		static bool IsMatch(const Chunk& chunk, u32 last_version) { return IsNewerVersion(chunk.GetChangeVersion(GET_COMPONENT_ID(Component)), last_version); }
+	};
+
+	template<class Component>
+	struct QueryTermTraits<Added<Component>> : QueryTermTraits<TypeList<>>
+	{
+		using Required = TypeList<Component>;
+		using Read = TypeList<Component>;
+		static bool IsMatch(const Chunk& chunk, u32 last_version) { return IsNewerVersion(chunk.GetAddVersion(GET_COMPONENT_ID(Component)), last_version); }
+	};
+
+	// ɈvArchetypeStorageNG
+	// World::GetQueryŎ擾 ^̑gݍ킹ƂWorld1쐬ĕێ
+	// ...Terms Query̏ Componenť^͂ComponentێĂȂ΂Ȃ
+	//          With, Without, Any, Optional, Changed, Added wł
+	//          PrefabɂĂ̏܂܂ȂꍇPrefabێĂArchetype͑ΏۂɂȂȂ
+	template<class ...Terms>
+	class Query : public QueryBase
+	{
+		// PrefabɂĂ̏ȂPrefabO
+		using PrefabExcluded = std::conditional_t<(QueryTermTraits<Terms>::kMentionsPrefab || ...), TypeList<>, TypeList<Prefab>>;
+
+	public:
+		Query() : QueryBase(
+			GetIds(typename ConcatTypeList<typename QueryTermTraits<Terms>::Required...>::Type{}),
+			GetIds(typename ConcatTypeList<typename QueryTermTraits<Terms>::Excluded..., PrefabExcluded>::Type{}),
+			GetIdsList(typename ConcatTypeList<typename QueryTermTraits<Terms>::AnyGroups...>::Type{}))
+		{
+		}
+
+		// ChunkׂĖ
+		static bool IsChunkMatch(const Chunk& chunk, u32 last_version)
+		{
+			return (QueryTermTraits<Terms>::IsMatch(chunk, last_version) && ...);
+		}
+
+	private:
+
+		template<class ...Components>
+		static std::span<const ComponentId> GetIds(TypeList<Components...>)
+		{
+			return Archetype::GetSortedComponentIds<Components...>();
+		}
+
+		template<class ...Groups>
+		static Vector<std::span<const ComponentId>> GetIdsList(TypeList<Groups...>)
+		{
+			return Vector<std::span<const ComponentId>>{ GetIds(Groups{})... };
+		}
+	};
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+
+// LComponent1̒l
+// ArchetypeStorage͓ArchetypełLComponent̒l̑gƂɕʁXɍ쐬AChunk͂̒l1ێ
+struct SharedComponentValue
+{
+	ComponentId id_;	// LComponentID
+	u32 index_;			// SharedComponentStoreł̒l̔ԍ ^œlȂ瓯ԍɂȂ
+	const void* value_;	// SharedComponentStoreێĂl
+};
+
+// LComponent̒l^ƂɏdȂێ
+// lWorldj܂ŉȂ̂ŁASharedComponentValue::value_͕ێĂ悢
+// LComponent̒l͓lmoperator==Ŕr1ɂ܂Ƃ߂ ނ̐̓}eA⃁bV̐xz肵Ă
+// World::LoadŌ^m炸ɒl𕜌ł悤ɁAl͌^Ƃ̔zł͂Ȃ1mۂČ^ĕێ
+class SharedComponentStore
+{
+public:
+	SharedComponentStore() = default;
+	~SharedComponentStore()
+	{
+		for(const Values& values : values_)
+		{
+			for(void* value : values.values_)
+			{
+				if(values.destroy_) values.destroy_(value);
+				::operator delete(value, std::align_val_t{ values.alignment_ });
+			}
+		}
+	}
+
+	SharedComponentStore(const SharedComponentStore&) = delete;
+	SharedComponentStore& operator=(const SharedComponentStore&) = delete;
+	SharedComponentStore(SharedComponentStore&&) = default;
+	SharedComponentStore& operator=(SharedComponentStore&&) = default;
+
+	// valueƓl擾A܂o^ĂȂꍇ͒ǉ
+	// Component ComponentSharedꉻĂComponenť^
+	template<class Component>
+	SharedComponentValue Add(const Component& value)
+	{
+		static_assert(SharedComponent<Component>, "ComponentSharedꉻĂȂComponentł");
+
+		const ComponentId id{ GET_COMPONENT_ID(Component) };
+		if(const std::optional<u32> index{ Find(value) }) return SharedComponentValue{ id, *index, values_[id].values_[*index] };
+
+		Values& values{ GetValues(id) };
+		if constexpr(!std::is_trivially_destructible_v<Component>)
+		{
+			values.destroy_ = [](void* p) { static_cast<Component*>(p)->~Component(); };
+		}
+		void* p{ ::operator new(sizeof(Component), std::align_val_t{ values.alignment_ }) };
+		new(p) Component(value);
+		values.values_.emplace_back(p);
+		return SharedComponentValue{ id, static_cast<u32>(values.values_.size()) - 1, p };
+	}
+
+	// valueƓl̔ԍ擾
+	// ߂l o^ĂȂꍇ(ǂChunk̒lێĂȂ̂)std::nullopt
+	template<class Component>
+	std::optional<u32> Find(const Component& value) const
+	{
+		static_assert(SharedComponent<Component>, "ComponentSharedꉻĂȂComponentł");
+
+		const ComponentId id{ GET_COMPONENT_ID(Component) };
+		if(id >= values_.size()) return std::nullopt;
+
+		const Vector<void*>& values{ values_[id].values_ };
+		const auto it{ std::ranges::find_if(values, [&value](const void* p) { return *static_cast<const Component*>(p) == value; }) };
+		if(it == values.end()) return std::nullopt;
+		return static_cast<u32>(it - values.begin());
+	}
+
+	// o^Ăl̐ World::SaveŎgp
+	u32 GetValueCounts(ComponentId id) const { return id < values_.size() ? static_cast<u32>(values_[id].values_.size()) : 0; }
+
+	// ԍ(SharedComponentValue::index_)̒l擾 World::SaveŎgp
+	const void* GetValue(ComponentId id, u32 index) const
+	{
+		_ASSERT_EXPR(index < GetValueCounts(id), L"o^ĂȂl̔ԍł");
+		return values_[id].values_[index];
+	}
+
+	// ̓ê܂܃Rs[l𖖔ɒǉ World::LoadŎgp
+	// lłɂ邩͊mFȂ̂ŁAۑƂƓɒǉΓԍɂȂ
+	// id grAɃRs[\ȋLComponentID
+	// value ComponentTypeRegistry::GetValueSizeoCg̒l
+	SharedComponentValue AddRaw(ComponentId id, const void* value)
+	{
+		_ASSERT_EXPR(ComponentTypeRegistry::IsShared(id) && ComponentTypeRegistry::IsTriviallyCopyable(id), L"grAɃRs[\ȋLComponentł͂܂");
+
+		Values& values{ GetValues(id) };
+		const u32 size{ ComponentTypeRegistry::GetValueSize(id) };
+		void* p{ ::operator new(size, std::align_val_t{ values.alignment_ }) };
+		std::memcpy(p, value, size);
+		values.values_.emplace_back(p);
+		return SharedComponentValue{ id, static_cast<u32>(values.values_.size()) - 1, p };
+	}
+
+private:
+
+	// ^Ƃ̒l vf1mۂĂ̂ŒǉĂ̒l̃AhX͕ςȂ
+	struct Values
+	{
+		Vector<void*> values_{};
+		void (*destroy_)(void*) {};	// fXgN^ grAɔjłꍇnullptr
+		u32 alignment_{};
+	};
+
+	Values& GetValues(ComponentId id)
+	{
+		if(id >= values_.size()) values_.resize(id + 1);
+
+		Values& values{ values_[id] };
+		if(values.alignment_ == 0) values.alignment_ = ComponentTypeRegistry::GetAlignment(id);
+		return values;
+	}
+
+	Vector<Values> values_{};	// ComponentIdIndexƂ^Ƃ̒l
+};
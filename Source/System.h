@@ -3,9 +3,54 @@
 #include "CommonHeader.h"
 #include "ECSCommon.h"
 #include "World.h"
+#include "EntityCommandBuffer.h"
 
 namespace ecs
 {
+	// SystemǂݏComponenẗꗗ
+	// SystemManager͂ɓɎsłSystem߂
+	struct SystemAccess
+	{
+		// Ɏsƌʂς\邩
+		// ǂ炩ComponentǂݏꍇA܂͂ǂ炩ȑꍇɏՓ˂
+		bool IsConflict(const SystemAccess& other) const
+		{
+			if(exclusive_ || other.exclusive_) return true;
+
+			const auto intersects = [](const Vector<ComponentId>& lhs, const Vector<ComponentId>& rhs)
+			{
+				return std::ranges::any_of(lhs, [&rhs](ComponentId id) { return std::ranges::binary_search(rhs, id); });
+			};
+			return intersects(write_ids_, other.write_ids_) || intersects(write_ids_, other.read_ids_) || intersects(read_ids_, other.write_ids_);
+		}
+
+		// ǉꍇtrueԂ
+		bool AddRead(ComponentId id) { return !Contains(write_ids_, id) && Insert(read_ids_, id); }
+
+		// ǉꍇtrueԂ ǂݍ݂Ƃēo^ς݂̏ꍇ͏݂ɕύX
+		bool AddWrite(ComponentId id)
+		{
+			if(!Insert(write_ids_, id)) return false;
+			std::erase(read_ids_, id);
+			return true;
+		}
+
+		Vector<ComponentId> read_ids_{};	// 
+		Vector<ComponentId> write_ids_{};	// 
+		bool exclusive_{};	// ̑SĂSystemƓɎsȂ
+
+	private:
+		static bool Contains(const Vector<ComponentId>& ids, ComponentId id) { return std::ranges::binary_search(ids, id); }
+
+		static bool Insert(Vector<ComponentId>& ids, ComponentId id)
+		{
+			const auto it{ std::ranges::lower_bound(ids, id) };
+			if(it != ids.end() && *it == id) return false;
+			ids.insert(it, id);
+			return true;
+		}
+	};
+
 	class BaseSystem
 	{
 		friend class SystemManager;
@@ -15,70 +60,526 @@ namespace ecs
 
 		virtual void Execute() {};
 
+		[[nodiscard]] const SystemAccess& GetAccess() const { return access_; }
+
 	protected:
 
+		// SystemManagerɒǉꂽƂ1񂾂Ă΂ sOɓǂݏComponent錾
+		// AddReadAccessAAddWriteAccessASetExclusiveĂ
+		// ForeachȂǂŎgpComponentSystem1sĂ(ǉ̍ŏ̎sȂ)ɎŋL^邪
+		// ɂĎsForeachWorldւ̒ڂ̃ANZX͂̎sŋL^Ƃ͌Ȃ̂ŁAŐ錾邱
+		virtual void DeclareAccess() {}
+
+		// ǂݍComponent錾
+		// DeclareAccess̒ŌĂ ForeachȂǂŎgpComponent͎œo^̂ŁAWorld璼ړǂݍޏꍇȂǂɎgp
+		template<class ...Components>
+		void AddReadAccess()
+		{
+			(RecordAccess<const Components>(), ...);
+		}
+
+		// Component錾
+		// DeclareAccess̒ŌĂ ForeachȂǂŎgpComponent͎œo^̂ŁAWorld璼ڏޏꍇȂǂɎgp
+		template<class ...Components>
+		void AddWriteAccess()
+		{
+			(RecordAccess<std::remove_const_t<Components>>(), ...);
+		}
+
+		// ̑SĂSystemƓɎsȂ悤ɂ
+		// WorldEntity𒼐ڒǉA폜ȂǁAComponenẗꗗŕ\ȂꍇɎgp
+		void SetExclusive()
+		{
+			if(access_.exclusive_) return;
+
+			_ASSERT_EXPR(!is_access_fixed_, L"Ɏsɔrɂ邱Ƃ͂ł܂ DeclareAccessŐ錾Ă");
+			access_.exclusive_ = true;
+			access_changed_ = true;
+		}
+
+		// ֐̈ComponentׂĕێĂEntityɑ΂Ċ֐Ăяo
+		// Componenẗꗗ͊֐̈狁߂̂ŁAev[g̎w͕sv
+		//  Foreach([](Transform& t, const Velocity& v) { ... });
+		//    Foreach([](Entity entity, const Transform& t) { ... });
+		//    Foreach<Changed<Transform>>([](Transform& t) { ... });
+		//    Foreach<Without<Static>>([](Transform& t, const Velocity* v) { if(v) { ... } });
+		// ...Filters Ώۂi荞ޏ
+		//            With<T...>, Without<T...>, Any<T...> ArchetypeƂɔ肷
+		//            Changed<T>, Added<T> O񂱂SystemsĂύX̂ȂChunk͌ĂяoȂ
+		// func _A֐|C^A֐IuWFNg std::functionoRȂ̂ŃCCWJł
+		//      T& ͏݁Aconst T& ܂͒ln͓ǂݍ݂݂̂ƂĈ
+		//      T*  const T* Optional<T>ƂĈATێĂȂEntityΏۂɂȂ ̏ꍇnullptrn
+		//      With, Changed, AddedɎw肵ComponentEnableableŖɂȂĂEntity͌ĂяoȂ |C^͖̈łn
+		//      LComponent const T& Ŏ󂯎AChunkEntityɂ͓ln
+		//      擪̈Entityɂꍇ͏Entityn
+		template<class ...Filters, class Func>
+		void Foreach(Func&& func)
+		{
+			ForeachImpl(func, typename FunctionTraits<std::remove_cvref_t<Func>>::Arguments{}, TypeList<Filters...>{});
+		}
+
+		// Foreach̕
+		// ΏۂChunk̍s͈͂ƂɕAWorldJobSystemŕɎs SĂ͈̔͂̎sIĂ߂
+		// ͈͂̕Chunk̍\min_batch_sizeŌ܂̂ŁAԂȂɓ͈͂ɕ
+		// ...Filters ForeachƓ
+		// func ForeachƓ ̃Xbh瓯ɌĂ΂ Entityɑ΂2Ă΂邱Ƃ͂Ȃ
+		// min_batch_size 1̃WuŏŏEntity̐
+		template<class ...Filters, class Func>
+		void ParallelForeach(Func&& func, u32 min_batch_size = kDefaultBatchSize)
+		{
+			ParallelForeachImpl(func, min_batch_size, typename FunctionTraits<std::remove_cvref_t<Func>>::Arguments{}, TypeList<Filters...>{});
+		}
+
+		// ֐̈ChunkViewComponentׂĕێĂChunkƂɊ֐Ăяo
+		// EntityƂł͂ȂŜ܂Ƃ߂ďꍇ(SIMDȂ)Ɏgp EntityێĂȂChunk͌ĂяoȂ
+		//  ForeachChunk([](ChunkView<Transform, const Velocity> view)
+		//    {
+		//        const auto transforms{ view.Get<Transform>() };
+		//        const auto velocities{ view.Get<const Velocity>() };
+		//        for(u32 i = 0; i < view.GetEntityCounts(); ++i) { ... }
+		//    });
+		// ...Filters ForeachƓ
+		// func void(ChunkView<Components...>) T ͏݁Aconst T ͓ǂݍ݂݂̂ƂĈ
+		//      Optional<T>w肵ꍇTێĂȂChunkΏۂɂȂA̗͋ɂȂ
+		//      Component̗L/͍lȂ̂ŁAKvłChunkView::GetEnabledBitsōi荞
+		template<class ...Filters, class Func>
+		void ForeachChunk(Func&& func)
+		{
+			ForeachChunkImpl(func, typename FunctionTraits<std::remove_cvref_t<Func>>::Arguments{}, TypeList<Filters...>{}, [](const Chunk&) { return true; });
+		}
+
+		// ForeachChunkƓALComponent̒lshared_valueƓChunkĂяo
+		// LComponent̒lƂChunkĂ̂ŁA}eAƂ̕`ȂǂœlEntityŜł܂Ƃ߂ďł
+		//  ForeachChunk(material, [](ChunkView<const Transform> view) { ... });
+		// shared_value ComponentSharedꉻĂComponent̒l ǂݍ݂ƂĈ
+		template<class ...Filters, class Shared, class Func>
+		void ForeachChunk(const Shared& shared_value, Func&& func)
+		{
+			static_assert(SharedComponent<Shared>, "ComponentSharedꉻĂȂComponentł");
+
+			// ̒lEntityxĂȂꍇ͂ǂChunkɂvȂԍɂ
+			const ComponentId id{ GET_COMPONENT_ID(Shared) };
+			const u32 index{ world_->FindSharedComponentIndex(shared_value).value_or(std::numeric_limits<u32>::max()) };
+			RecordAccess<const Shared>();
+			ForeachChunkImpl(func, typename FunctionTraits<std::remove_cvref_t<Func>>::Arguments{}, TypeList<With<Shared>, Filters...>{},
+				[id, index](const Chunk& chunk) { return chunk.GetSharedComponentIndex(id) == index; });
+		}
+
+		// O񂱂SystemsƂWorld̕ύXo[W xsĂȂꍇ0
+		u32 GetLastSystemVersion() const { return last_system_version_; }
+
+		// s̃XbhpEntityCommandBuffer擾
+		// Foreach̒Entity̍쐬폜sꍇ͂ɋL^
+		EntityCommandBuffer& GetEntityCommandBuffer() const { return world_->GetEntityCommandBuffer(); }
+
+	private:
+
+		void SetWorld(World* world) { world_ = world; }
+
+		// SystemManagerĂ΂ sɍ̕ύXo[WL^
+		// version sOWorldi߂ύXo[W
+		void Run(u32 version)
+		{
+#if ECS_PROFILER_ENABLED
+			SystemProfiler& profiler{ world_->GetProfiler() };
+			profile_counts_ = {};
+			const u64 begin{ profiler.Now() };
+			Execute();
+			profiler.Record(profile_id_, begin, profiler.Now(), profile_counts_);
+#else
+			Execute();
+#endif
+			last_system_version_ = version;
+		}
+
+		// Component̃ANZXL^ constȂǂݍ݁AȊO͏
+		// VL^ꂽꍇSystemManager̃t[Ŏs蒼
+		// Ɏs͓Xe[WSystemƏՓ˂Ă\̂ŁA錾ĂȂANZX̓AT[g
 		template<class T>
-		void Foreach(std::function<void(T&)>&& func)
+		void RecordAccess()
+		{
+			const ComponentId id{ GET_COMPONENT_ID(T) };
+			const bool added{ std::is_const_v<std::remove_reference_t<T>> ? access_.AddRead(id) : access_.AddWrite(id) };
+			if(!added) return;
+
+			_ASSERT_EXPR(!is_access_fixed_, L"錾ĂȂComponentɕɎsɃANZX܂ DeclareAccessŐ錾Ă");
+			access_changed_ = true;
+		}
+
+		// Foreachɓnꂽ֐̈̌^AChunk̗̗vf̌^߂
+		// T& ͏݂Ȃ̂TAconst T& ƒln͓ǂݍ݂݂̂Ȃ̂const T
+		// T*  const T* ̓|C^O^
+		template<class Arg>
+		using ColumnType = std::conditional_t<std::is_pointer_v<std::remove_cvref_t<Arg>>, std::remove_pointer_t<std::remove_cvref_t<Arg>>,
+			std::conditional_t<std::is_lvalue_reference_v<Arg> && !std::is_const_v<std::remove_reference_t<Arg>>,
+			std::remove_reference_t<Arg>, const std::remove_cvref_t<Arg>>>;
+
+		// Foreachɓnꂽ֐̈̌^AQuery̏߂ |C^̈Optional
+		template<class Arg>
+		using QueryTerm = std::conditional_t<std::is_pointer_v<std::remove_cvref_t<Arg>>,
+			Optional<std::remove_cv_t<ColumnType<Arg>>>, std::remove_cvref_t<Arg>>;
+
+		// ForeachŗLɂȂĂȂ΂ȂEnableableComponentTypeList
+		// |C^ȊÖƁAtB^ŕێĂȂ΂ȂComponentΏ
+		template<class ArgList, class FilterList>
+		struct EnabledComponentsImpl;
+
+		template<class ...Args, class ...Filters>
+		struct EnabledComponentsImpl<TypeList<Args...>, TypeList<Filters...>>
 		{
-			Vector<SharedPtr<Chunk>> chunk_list{ world_->GetChunkList<T>() };
-			for(auto&& chunk : chunk_list)
+			using Type = typename EnableableTypeList<typename ConcatTypeList<
+				std::conditional_t<std::is_pointer_v<std::remove_cvref_t<Args>>, TypeList<>, TypeList<ColumnType<Args>>>...,
+				typename QueryTermTraits<Filters>::Required...>::Type>::Type;
+		};
+
+		template<class ArgList, class FilterList>
+		using EnabledComponents = typename EnabledComponentsImpl<ArgList, FilterList>::Type;
+
+		// 擪̈Entity̏ꍇ͎菜Componenẗɂ
+		template<class Func, class First, class ...Args, class ...Filters>
+			requires std::is_same_v<std::remove_cvref_t<First>, Entity>
+		void ForeachImpl(Func& func, TypeList<First, Args...>, TypeList<Filters...> filters)
+		{
+			ForeachImpl<true>(func, TypeList<Args...>{}, filters);
+		}
+
+		template<bool kWithEntity = false, class Func, class ...Args, class ...Filters>
+		void ForeachImpl(Func& func, TypeList<Args...>, TypeList<Filters...> filters)
+		{
+			static_assert((!std::is_rvalue_reference_v<Args> && ...), "ComponenẗEӒlQƂɂ邱Ƃ͂ł܂");
+			(RecordAccess<ColumnType<Args>>(), ...);
+			ForeachFilteredChunk<QueryTerm<Args>...>(filters, [&func](Chunk& chunk)
 			{
-				auto args{ chunk->GetComponentArray<T>() };
-				ForeachImpl(chunk.get(), func, args);
-			}
+				ForeachRows<kWithEntity, Args...>(chunk, 0, chunk.GetEntityCounts(), func, EnabledComponents<TypeList<Args...>, TypeList<Filters...>>{});
+			});
+		}
+
+		template<class Func, class First, class ...Args, class ...Filters>
+			requires std::is_same_v<std::remove_cvref_t<First>, Entity>
+		void ParallelForeachImpl(Func& func, u32 min_batch_size, TypeList<First, Args...>, TypeList<Filters...> filters)
+		{
+			ParallelForeachImpl<true>(func, min_batch_size, TypeList<Args...>{}, filters);
 		}
 
-		template<class T0, class T1>
-		void Foreach(std::function<void(T0&, T1&)>&& func)
+		template<bool kWithEntity = false, class Func, class ...Args, class ...Filters>
+		void ParallelForeachImpl(Func& func, u32 min_batch_size, TypeList<Args...>, TypeList<Filters...> filters)
 		{
-			Vector<SharedPtr<Chunk>> chunk_list{ world_->GetChunkList<T0, T1>() };
-			for(auto&& chunk : chunk_list)
+			static_assert((!std::is_rvalue_reference_v<Args> && ...), "ComponenẗEӒlQƂɂ邱Ƃ͂ł܂");
+			(RecordAccess<ColumnType<Args>>(), ...);
+			CreateParallelRanges([this, filters](auto&& add_chunk)
 			{
-				auto args0{ chunk->GetComponentArray<T0>() };
-				auto args1{ chunk->GetComponentArray<T1>() };
-				ForeachImpl(chunk.get(), func, args0, args1);
-			}
+				ForeachFilteredChunk<QueryTerm<Args>...>(filters, add_chunk);
+			}, min_batch_size);
+			world_->GetJobSystem().ParallelFor(GetParallelJobCounts(), [this, &func](u32 job_index)
+			{
+				for(u32 i = parallel_job_offsets_[job_index]; i < parallel_job_offsets_[job_index + 1]; ++i)
+				{
+					const ParallelRange& range{ parallel_ranges_[i] };
+					ForeachRows<kWithEntity, Args...>(*range.chunk_, range.begin_, range.end_, func, EnabledComponents<TypeList<Args...>, TypeList<Filters...>>{});
+				}
+			});
 		}
 
-	private:
+		// is_target_chunk bool(const Chunk&) falseԂChunk͌ĂяoȂ
+		template<class Func, class View, class ...Filters, class Predicate>
+		void ForeachChunkImpl(Func& func, TypeList<View>, TypeList<Filters...> filters, const Predicate& is_target_chunk)
+		{
+			ForeachChunkImpl(func, std::type_identity<std::remove_cvref_t<View>>{}, filters, is_target_chunk);
+		}
 
-		void SetWorld(World* world) { world_ = world; }
+		template<class Func, class ...Components, class ...Filters, class Predicate>
+		void ForeachChunkImpl(Func& func, std::type_identity<ChunkView<Components...>>, TypeList<Filters...> filters, const Predicate& is_target_chunk)
+		{
+			(RecordAccess<typename ChunkViewColumn<Components>::Type>(), ...);
+			ForeachFilteredChunk<Components...>(filters, [&func, &is_target_chunk](Chunk& chunk)
+			{
+				if(is_target_chunk(chunk)) func(ChunkView<Components...>{ chunk });
+			});
+		}
 
-		template<typename Func, typename... Args>
-		static void ForeachImpl( Chunk* pChunk, Func&& func, Args ... args )
+		// TermsƃtB^ׂ̏ĖChunkɑ΂Ċ֐Ăяo
+		// Changed, Added̑ΏۂComponent͓ǂݍ݂ƂċL^
+		// func void(Chunk&)
+		template<class ...Terms, class ...Filters, class Func>
+		void ForeachFilteredChunk(TypeList<Filters...>, Func&& func)
 		{
-			for ( std::uint32_t i = 0; i < pChunk->GetEntityCounts(); ++i )
+			using FilteredQuery = Query<Terms..., Filters...>;
+			RecordReadAccess(typename ConcatTypeList<typename QueryTermTraits<Filters>::Read...>::Type{});
+
+#if ECS_PROFILER_ENABLED
+			// ʂ̋L^p Chunk̗Ƃēǂݏ1s̃TCY ^OƋLComponent0
+			// ComponentTypeRegistry̓bN̂ŁA^̑gݍ킹Ƃ1񂾂߂
+			static const u64 row_bytes{ GetRowBytes(typename ConcatTypeList<typename QueryTermTraits<Terms>::Required...>::Type{}) };
+#endif
+
+			world_->GetQuery<Terms..., Filters...>().ForeachChunk([this, &func](Chunk& chunk)
+			{
+				if(!FilteredQuery::IsChunkMatch(chunk, last_system_version_)) return;
+
+#if ECS_PROFILER_ENABLED
+				++profile_counts_.chunk_counts_;
+				profile_counts_.entity_counts_ += chunk.GetEntityCounts();
+				profile_counts_.bytes_ += row_bytes * chunk.GetEntityCounts();
+#endif
+				func(chunk);
+			});
+		}
+
+		template<class ...Components>
+		static u64 GetRowBytes(TypeList<Components...>)
+		{
+			return (u64{} + ... + ComponentTypeRegistry::GetSize(GET_COMPONENT_ID(Components)));
+		}
+
+		template<class ...Components>
+		void RecordReadAccess(TypeList<Components...>)
+		{
+			(RecordAccess<const Components>(), ...);
+		}
+
+		// Chunk[begin, end)̍sɑ΂Ċ֐Ăяo
+		// ̐擪̃|C^擾Ă烋[v̂ŁA[v͓YANZXƊ֐̌ĂяoɂȂ
+		// ...Enabled LɂȂĂȂ΂ȂComponent łȂꍇ͗L/̃rbg64sANDAĂrbg̍sĂяo
+		template<bool kWithEntity, class ...Args, class Func, class ...Enabled>
+		static void ForeachRows(Chunk& chunk, u32 begin, u32 end, Func& func, TypeList<Enabled...>)
+		{
+			const Entity* entities{ chunk.GetEntities().data() };
+			[&func, &chunk, begin, end, entities](ColumnType<Args>* ...columns)
 			{
-				func( args[i]... );
+				const auto call{ [&](u32 i)
+				{
+					if constexpr(kWithEntity) func(entities[i], GetRow<Args>(columns, i)...);
+					else func(GetRow<Args>(columns, i)...);
+				} };
+
+				if constexpr(sizeof...(Enabled) == 0)
+				{
+					for(u32 i = begin; i < end; ++i) call(i);
+				}
+				else
+				{
+					constexpr u32 kBits{ Chunk::kEnabledBitsPerWord };
+					const std::array<const u64*, sizeof...(Enabled)> enabled_bits{ chunk.GetEnabledBits(GET_COMPONENT_ID(Enabled)).data()... };
+					for(u32 word = begin / kBits; word * kBits < end; ++word)
+					{
+						// [begin, end)̊Õrbg𗎂Ƃ
+						const u32 row{ word * kBits };
+						u64 bits{ ~0ull };
+						if(row < begin) bits &= ~0ull << (begin - row);
+						if(row + kBits > end) bits &= ~0ull >> (row + kBits - end);
+						for(const u64* enabled : enabled_bits) bits &= enabled[word];
+
+						while(bits != 0)
+						{
+							call(row + static_cast<u32>(std::countr_zero(bits)));
+							bits &= bits - 1;
+						}
+					}
+				}
+			}(GetColumn<Args>(chunk)...);
+		}
+
+		// ɑΉChunk̗̐擪 |C^̈ChunkێĂȂꍇnullptr
+		// LComponent̏ꍇChunkێĂ1̒l
+		template<class Arg>
+		static ColumnType<Arg>* GetColumn(Chunk& chunk)
+		{
+			if constexpr(std::is_pointer_v<std::remove_cvref_t<Arg>>)
+			{
+				if(!chunk.HasComponent(GET_COMPONENT_ID(ColumnType<Arg>))) return nullptr;
+			}
+			if constexpr(SharedComponent<std::remove_cv_t<ColumnType<Arg>>>)
+			{
+				static_assert(std::is_const_v<ColumnType<Arg>>, "LComponentChunkƂ̒lȂ̂constŎ󂯎Ă");
+				return &chunk.GetSharedComponent<ColumnType<Arg>>();
+			}
+			else
+			{
+				return chunk.GetComponentSpan<ColumnType<Arg>>().data();
+			}
+		}
+
+		// ɓns̒l |C^̈ɂ͍s̃|C^(񂪂Ȃꍇnullptr)n
+		// LComponentׂ͂Ă̍sœln
+		template<class Arg>
+		static decltype(auto) GetRow(ColumnType<Arg>* column, u32 index)
+		{
+			if constexpr(SharedComponent<std::remove_cv_t<ColumnType<Arg>>>)
+			{
+				if constexpr(std::is_pointer_v<std::remove_cvref_t<Arg>>) return column;
+				else return (*column);
 			}
+			else if constexpr(std::is_pointer_v<std::remove_cvref_t<Arg>>) return column ? column + index : nullptr;
+			else return (column[index]);
 		}
 
+		// ParallelForeachŎs͈͂쐬
+		// eChunkmin_batch_sizeȏ̍sƂɕAmin_batch_sizeɖȂChunk͘A̓m1̃Wuɂ܂Ƃ߂
+		// foreach_chunk void(add_chunk) ΏۂChunkƂadd_chunk(Chunk&)Ăяo֐
+		template<class ForeachChunkFunc>
+		void CreateParallelRanges(ForeachChunkFunc&& foreach_chunk, u32 min_batch_size)
+		{
+			min_batch_size = std::max(min_batch_size, 1u);
+			parallel_ranges_.clear();
+			parallel_job_offsets_.clear();
+			parallel_job_offsets_.emplace_back(0);
+
+			u32 job_entity_counts{};
+			foreach_chunk([this, min_batch_size, &job_entity_counts](Chunk& chunk)
+			{
+				const u32 entity_counts{ chunk.GetEntityCounts() };
+				const u32 split_counts{ std::max(entity_counts / min_batch_size, 1u) };
+				for(u32 i = 0; i < split_counts; ++i)
+				{
+					const u32 begin{ entity_counts * i / split_counts };
+					const u32 end{ entity_counts * (i + 1) / split_counts };
+					parallel_ranges_.emplace_back(ParallelRange{ &chunk, begin, end });
+
+					job_entity_counts += end - begin;
+					if(job_entity_counts >= min_batch_size)
+					{
+						parallel_job_offsets_.emplace_back(static_cast<u32>(parallel_ranges_.size()));
+						job_entity_counts = 0;
+					}
+				}
+			});
+
+			if(job_entity_counts != 0) parallel_job_offsets_.emplace_back(static_cast<u32>(parallel_ranges_.size()));
+		}
+
+		u32 GetParallelJobCounts() const { return static_cast<u32>(parallel_job_offsets_.size()) - 1; }
+
 	protected:
+		static constexpr u32 kDefaultBatchSize{ 256 };	// ParallelForeach1̃WuŏŏEntity̐̊l
+
 		World* world_;
+
+	private:
+		// ParallelForeach1̃WuChunk͈̔
+		struct ParallelRange
+		{
+			Chunk* chunk_;
+			u32 begin_;
+			u32 end_;
+		};
+
+		Vector<ParallelRange> parallel_ranges_{};	// mۂȂ悤Ɏg܂킷
+		Vector<u32> parallel_job_offsets_{};		// WuƂparallel_ranges_̐擪Index ɂ͏I[i[
+
+		SystemAccess access_{};
+		bool access_changed_{};	// OSystemManagersĂaccess_ς
+		bool is_access_fixed_{};	// access_ɍsŕɎsĂ邩 VANZX̋L^̓AT[g
+
+		u32 last_system_version_{};	// OsƂWorld̕ύXo[W Changed<T>AAdded<T>̔Ɏgp
+
+#if ECS_PROFILER_ENABLED
+		u32 profile_id_{};						// SystemProfiler::AddSystem̖߂l
+		SystemProfileCounts profile_counts_{};	// s̏ Foreachn̊֐ZARun̍ŌSystemProfilerɋL^
+#endif
 	};
 
+	// System̊ǗƎss
+	// eSystemComponent̃ANZXˑ֌W߁AՓ˂ȂSystemmWorldJobSystemŕɎs
+	// Փ˂Systemm͒ǉꂽԂɎs
 	class SystemManager
 	{
 	public:
 		SystemManager(World* world) : world_(world) {}
 
+		// SĂSystems
+		// Systemǉ̎sSystem̃ANZXς̎śAǉꂽԂ1s
+		// DeclareAccessŐ錾ANZXƂ̊ԂɋL^ꂽANZXs(Xe[W)蒼
+		// Xe[WSystem͕ɎsAXe[Wm͏ԂɎs
 		void Execute()
 		{
-			for(auto& system : systems_)
+#if ECS_PROFILER_ENABLED
+			const u64 frame_begin{ world_->GetProfiler().BeginFrame() };
+#endif
+
+			if(!is_schedule_valid_)
 			{
-				system->Execute();
+				for(auto& system : systems_)
+				{
+					system->is_access_fixed_ = false;
+					system->Run(world_->AdvanceChangeVersion());
+				}
+				CreateSchedule();
 			}
+			else
+			{
+				// Xe[WSystem͓ComponentɓǂݏȂ̂ŁAύXo[W̓Xe[WƂɐi߂΂悢
+				for(const Vector<u32>& stage : stages_)
+				{
+					const u32 version{ world_->AdvanceChangeVersion() };
+					world_->GetJobSystem().ParallelFor(static_cast<u32>(stage.size()), [this, &stage, version](u32 i)
+					{
+						systems_[stage[i]]->Run(version);
+					});
+				}
+
+				// 錾ĂȂANZXꍇ(AT[gȃrh)͎̎sō蒼
+				is_schedule_valid_ = std::ranges::none_of(systems_, [](const auto& system) { return system->access_changed_; });
+			}
+
+			// System̊O(EntityCommandBuffer̎sȂ)ł̕ύXǂSystem̑O̎sVȂ悤ɐi߂Ă
+			world_->AdvanceChangeVersion();
+
+#if ECS_PROFILER_ENABLED
+			world_->GetProfiler().EndFrame(frame_begin);
+#endif
 		}
+
 		template<class ...Systems>
 		void AddSystems()
 		{
-			_ASSERT_EXPR(world_, L"Worldnullptrł");
+			_ASSERT_EXPR(world_, L"Worldnullptrł");
 			AddSystemImpl<Systems...>();
+			is_schedule_valid_ = false;
 		}
 
 		template<class ...Systems>
 		void RemoveSystems();
 
+		// s擾 Xe[WƂSystemIndex(ǉꂽ)
+		[[nodiscard]] const Vector<Vector<u32>>& GetSchedule() const { return stages_; }
+
+		// smFp̕ɂ
+		// System̖OGetTypeName̖O(OԂ܂)
+		//  Stage 0: UpdateTransform (write: Transform) | UpdateLight (read: Transform)
+		String DumpSchedule() const
+		{
+			const auto append_ids = [](String& out, const char* label, const Vector<ComponentId>& ids)
+			{
+				if(ids.empty()) return;
+				out += label;
+				for(u64 i = 0; i < ids.size(); ++i)
+				{
+					if(i != 0) out += ", ";
+					out += ComponentTypeRegistry::GetName(ids[i]);
+				}
+			};
+
+			String ret{};
+			for(u64 stage_index = 0; stage_index < stages_.size(); ++stage_index)
+			{
+				ret += "Stage " + std::to_string(stage_index) + ":";
+				for(u64 i = 0; i < stages_[stage_index].size(); ++i)
+				{
+					const u32 system_index{ stages_[stage_index][i] };
+					const SystemAccess& access{ systems_[system_index]->GetAccess() };
+					ret += i == 0 ? " " : " | ";
+					ret += system_names_[system_index];
+					ret += " (";
+					if(access.exclusive_) ret += "exclusive";
+					append_ids(ret, access.exclusive_ ? "; read: " : "read: ", access.read_ids_);
+					append_ids(ret, access.read_ids_.empty() && !access.exclusive_ ? "write: " : "; write: ", access.write_ids_);
+					ret += ")";
+				}
+				ret += "\n";
+			}
+			return ret;
+		}
+
 	private:
 
 		template<class Head, class ...Tails>
@@ -91,12 +592,45 @@ namespace ecs
 			{
 				UniquePtr<Head> system{ std::make_unique<Head>() };
 				system->SetWorld(world_);
+				static_cast<BaseSystem&>(*system).DeclareAccess();	// hNXprotectedɂĂĂׂ悤ɊNXĂ
+#if ECS_PROFILER_ENABLED
+				system->profile_id_ = world_->GetProfiler().AddSystem(GetTypeName<Head>());
+#endif
 				systems_.emplace_back(std::move(system));
+				system_names_.emplace_back(GetTypeName<Head>());
+				system_ids_.insert(id);
 			}
 
 			if constexpr(sizeof...(Tails) != 0) AddSystemImpl<Tails...>();
 		}
 
+		// eSystem̃ANZXs
+		// Փ˂ɒǉꂽSystem̒ōł̃Xe[W̎̃Xe[Wɔzu
+		void CreateSchedule()
+		{
+			stages_.clear();
+			Vector<u32> system_stages(systems_.size());
+			for(u32 i = 0; i < systems_.size(); ++i)
+			{
+				u32 stage{};
+				for(u32 j = 0; j < i; ++j)
+				{
+					if(systems_[i]->GetAccess().IsConflict(systems_[j]->GetAccess())) stage = std::max(stage, system_stages[j] + 1);
+				}
+				system_stages[i] = stage;
+
+				if(stage >= stages_.size()) stages_.resize(stage + 1);
+				stages_[stage].emplace_back(i);
+			}
+
+			for(auto& system : systems_)
+			{
+				system->access_changed_ = false;
+				system->is_access_fixed_ = true;
+			}
+			is_schedule_valid_ = true;
+		}
+
 	private:
 
 		template<class System>
@@ -108,8 +642,10 @@ namespace ecs
 	private:
 		World* world_;
 		Vector<UniquePtr<BaseSystem>> systems_;
-#ifdef _DEBUG
+		Vector<String> system_names_;	// DumpSchedulep
 		UnorderedSet<u64> system_ids_;
-#endif
+
+		Vector<Vector<u32>> stages_{};	// Xe[WƂSystemIndex
+		bool is_schedule_valid_{};
 	};
 }
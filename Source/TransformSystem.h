@@ -0,0 +1,424 @@
+#pragma once
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+#include "World.h"
+#include "System.h"
+
+#ifdef ECS_NO_DIRECTXMATH
+#error "TransformSystem͍švZDirectXMathgp̂ŁAECS_NO_DIRECTXMATH`rhł͎gpłȂ"
+#endif
+
+namespace ecs
+{
+	// [JԂł̈ʒuA]Ag eȂꍇ̓[h
+	struct LocalTransform
+	{
+		float3 position_{ 0.0f, 0.0f, 0.0f };
+		float4 rotation_{ 0.0f, 0.0f, 0.0f, 1.0f };	// NH[^jI
+		float3 scale_{ 1.0f, 1.0f, 1.0f };
+	};
+
+	// [hs TransformSystemLocalTransformƐeLocalToWorldvZ
+	struct LocalToWorld
+	{
+		float4x4 matrix_
+		{
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f
+		};
+	};
+
+	// eEntity SetParentŐݒ肷
+	// eEntitymnext_sibling_ŌqXgɂȂĂāA擪͐eChildrenێ
+	struct Parent
+	{
+		Entity parent_{};
+		Entity next_sibling_{};	// e̎̎q ̏ꍇ͖Entity
+	};
+
+	// qEntitỹXg̐擪 qEntitySetParentǉ
+	struct Children
+	{
+		Entity first_child_{};
+		u32 counts_{};
+	};
+
+	// [g̐[ ParentEntitySetParentǉ([g̎q1)
+	// LComponentȂ̂œ[Entity͓Chunkɂ܂Ƃ܂ATransformSystem͐[ƂɘAChunkł
+	struct HierarchyDepth
+	{
+		u32 depth_{};
+
+		bool operator==(const HierarchyDepth&) const = default;
+	};
+}
+
+template<>
+struct ComponentShared<ecs::HierarchyDepth> : std::true_type {};
+
+namespace ecs
+{
+	namespace detail
+	{
+		// parent̎q̃XgParent̗񂩂蒼
+		// ParentChunkׂđ̂ŁA폜ꂽEntityXgɎcĂꍇɂgp
+		inline void RebuildChildren(World& world, Entity parent)
+		{
+			Vector<Entity> children{};
+			world.GetQuery<Parent>().ForeachChunk([parent, &children](Chunk& chunk)
+			{
+				const std::span<const Parent> parents{ chunk.GetComponentSpan<const Parent>() };
+				const std::span<const Entity> entities{ chunk.GetEntities() };
+				for(u32 i = 0; i < parents.size(); ++i)
+				{
+					if(parents[i].parent_ == parent) children.emplace_back(entities[i]);
+				}
+			});
+
+			if(children.empty())
+			{
+				world.RemoveComponent<Children>(parent);
+				return;
+			}
+			for(u64 i = 0; i < children.size(); ++i)
+			{
+				world.SetComponentData(children[i], Parent{ parent, i + 1 < children.size() ? children[i + 1] : Entity{} });
+			}
+			world.SetComponentData(parent, Children{ children.front(), static_cast<u32>(children.size()) });
+		}
+
+		// parent̎q̃Xgɍ폜ꂽEntitycĂꍇ͍蒼
+		// World::RemoveEntityŒڍ폜ꂽq̓XgOȂ̂ŁAXgHOɌĂ
+		inline void ValidateChildren(World& world, Entity parent)
+		{
+			if(!world.HasComponent<Children>(parent)) return;
+
+			const Children children{ world.GetComponentData<Children>(parent) };
+			u32 counts{};
+			for(Entity child{ children.first_child_ }; child != Entity{}; child = world.GetComponentData<Parent>(child).next_sibling_)
+			{
+				if(!world.IsAlive(child))
+				{
+					RebuildChildren(world, parent);
+					return;
+				}
+				++counts;
+			}
+			if(counts != children.counts_) RebuildChildren(world, parent);
+		}
+
+		// entity̎qHierarchyDepthXV
+		// depth entity̐[ qdepth + 1ɂȂ
+		inline void UpdateDescendantsDepth(World& world, Entity entity, u32 depth)
+		{
+			ValidateChildren(world, entity);
+			if(!world.HasComponent<Children>(entity)) return;
+
+			for(Entity child{ world.GetComponentData<Children>(entity).first_child_ }; child != Entity{}; child = world.GetComponentData<Parent>(child).next_sibling_)
+			{
+				world.SetSharedComponent(child, HierarchyDepth{ depth + 1 });
+				UpdateDescendantsDepth(world, child, depth + 1);
+			}
+		}
+
+		// e̎q̃XgchildO childParentHierarchyDepth͂̂܂܎c
+		// e폜ς݂̏ꍇ̓XgcĂȂ̂ŉȂ
+		// parent childێĂParent
+		inline void UnlinkChild(World& world, Entity child, const Parent& parent)
+		{
+			if(!world.IsAlive(parent.parent_)) return;
+
+			ValidateChildren(world, parent.parent_);
+			Children children{ world.GetComponentData<Children>(parent.parent_) };
+			const Entity next_sibling{ world.GetComponentData<Parent>(child).next_sibling_ };	// 蒼ꍇparentƈقȂ
+			if(children.first_child_ == child)
+			{
+				children.first_child_ = next_sibling;
+			}
+			else
+			{
+				Entity prev{ children.first_child_ };
+				Parent prev_parent{ world.GetComponentData<Parent>(prev) };
+				while(prev_parent.next_sibling_ != child)
+				{
+					prev = prev_parent.next_sibling_;
+					prev_parent = world.GetComponentData<Parent>(prev);
+				}
+				prev_parent.next_sibling_ = next_sibling;
+				world.SetComponentData(prev, prev_parent);
+			}
+
+			if(--children.counts_ == 0) world.RemoveComponent<Children>(parent.parent_);
+			else world.SetComponentData(parent.parent_, children);
+		}
+	}
+
+	// child̐eOă[gɂ eȂꍇ͉Ȃ
+	// Entitÿړ𔺂̂ŁASystem̎sł͂ȂEntityCommandBuffer̍ĐȂǂɌĂԂ
+	inline void RemoveParent(World& world, Entity child)
+	{
+		if(!world.HasComponent<Parent>(child)) return;
+
+		detail::UnlinkChild(world, child, world.GetComponentData<Parent>(child));
+		world.RemoveComponents<Parent, HierarchyDepth>(child);
+		detail::UpdateDescendantsDepth(world, child, 0);
+	}
+
+	// KwɊ܂܂Entity폜 e̎q̃XgOAq̓[gɂ
+	// World::RemoveEntityŒڍ폜ƐeChildrenɍ폜EntitycAɃXgHƂɍ蒼ƂɂȂ
+	// Entitÿړ𔺂̂ŁASystem̎sł͂ȂEntityCommandBuffer̍ĐȂǂɌĂԂ
+	inline void RemoveHierarchyEntity(World& world, Entity entity)
+	{
+		if(world.HasComponent<Parent>(entity)) detail::UnlinkChild(world, entity, world.GetComponentData<Parent>(entity));
+
+		detail::ValidateChildren(world, entity);
+		if(world.HasComponent<Children>(entity))
+		{
+			Vector<Entity> children{};
+			for(Entity child{ world.GetComponentData<Children>(entity).first_child_ }; child != Entity{}; child = world.GetComponentData<Parent>(child).next_sibling_)
+			{
+				children.emplace_back(child);
+			}
+			for(const Entity child : children)
+			{
+				world.RemoveComponents<Parent, HierarchyDepth>(child);
+				detail::UpdateDescendantsDepth(world, child, 0);
+			}
+		}
+		world.RemoveEntity(entity);
+	}
+
+	// child̐eparentɂ łɐeꍇ͕tւ
+	// child̈ړ͍ő1(ParentHierarchyDepth܂Ƃ߂Ēǉ邩A[ςꍇHierarchyDepthu)
+	// [ςꍇ͎qHierarchyDepthXV̂ŁAq͂ꂼ̐[ChunkɈړ
+	// Entitÿړ𔺂̂ŁASystem̎sł͂ȂEntityCommandBuffer̍ĐȂǂɌĂԂ
+	// child LocalTransformLocalToWorldێĂEntity
+	// parent LocalToWorldێĂEntity child̎q͎włȂ
+	inline void SetParent(World& world, Entity child, Entity parent)
+	{
+		_ASSERT_EXPR(world.HasComponent<LocalToWorld>(parent), L"eLocalToWorldێĂȂ΂Ȃ܂");
+		for(Entity ancestor{ parent }; ; ancestor = world.GetComponentData<Parent>(ancestor).parent_)
+		{
+			_ASSERT_EXPR(ancestor != child, L"gqeɂ邱Ƃ͂ł܂");
+			if(!world.HasComponent<Parent>(ancestor)) break;
+		}
+
+		const bool has_parent{ world.HasComponent<Parent>(child) };
+		u32 old_depth{};
+		if(has_parent)
+		{
+			const Parent old_parent{ world.GetComponentData<Parent>(child) };
+			if(old_parent.parent_ == parent) return;
+
+			detail::UnlinkChild(world, child, old_parent);
+			old_depth = world.GetSharedComponent<HierarchyDepth>(child).depth_;
+		}
+
+		// e̎q̃Xg̐擪Ɍq
+		detail::ValidateChildren(world, parent);
+		const bool has_children{ world.HasComponent<Children>(parent) };
+		Children children{ has_children ? world.GetComponentData<Children>(parent) : Children{} };
+		const Parent link{ parent, children.first_child_ };
+		children.first_child_ = child;
+		++children.counts_;
+		if(has_children) world.SetComponentData(parent, children);
+		else world.AddComponent(parent, children);
+
+		const u32 depth{ world.HasComponent<HierarchyDepth>(parent) ? world.GetSharedComponent<HierarchyDepth>(parent).depth_ + 1 : 1 };
+		if(has_parent)
+		{
+			world.SetComponentData(child, link);
+			if(depth != old_depth) world.SetSharedComponent(child, HierarchyDepth{ depth });
+		}
+		else
+		{
+			world.AddComponents(child, link, HierarchyDepth{ depth });
+		}
+		if(depth != old_depth) detail::UpdateDescendantsDepth(world, child, depth);
+	}
+
+	// LocalTransformƐeLocalToWorldLocalToWorldvZ
+	// HierarchyDepthƂɐ󂢏ɏ̂ŁAeLocalToWorld͏ɌvZς
+	// [Chunk݂͌ɈˑȂ̂WorldJobSystemŕɏ
+	// [Ƃ̏̌ɁAChildrenEntityLocalToWorldւ̃|C^ƕύX̗LEntityIdň\ɋL^Ă
+	// ̐[ł͐ẽf[^World1ɕ\ǂݍ
+	// O̎s LocalTransformAParentAeLocalToWorld ̂ύXĂȂEntity͌vZȂ
+	// ύX̔ChunkPʂȂ̂ŁAChunk̑EntityeƓChunk̑EntityύXꂽꍇvZ
+	// e폜ꂽEntity̓[gƂČvZAEntityCommandBufferParentHierarchyDepth폜
+	class TransformSystem : public BaseSystem
+	{
+	public:
+		TransformSystem() = default;
+
+		void Execute() override
+		{
+			// [ƂChunk𕪂 [g0
+			for(Vector<Chunk*>& level : levels_) level.clear();
+			if(levels_.empty()) levels_.resize(1);
+
+			world_->GetQuery<LocalTransform, LocalToWorld, Without<Parent>>().ForeachChunk([this](Chunk& chunk)
+			{
+				levels_[0].emplace_back(&chunk);
+			});
+			world_->GetQuery<LocalTransform, LocalToWorld, Parent, HierarchyDepth>().ForeachChunk([this](Chunk& chunk)
+			{
+				const u32 depth{ chunk.GetSharedComponent<HierarchyDepth>().depth_ };
+				if(depth >= levels_.size()) levels_.resize(depth + 1);
+				levels_[depth].emplace_back(&chunk);
+			});
+
+			const u32 last_version{ GetLastSystemVersion() };
+			const Vector<Chunk*>& roots{ levels_[0] };
+			world_->GetJobSystem().ParallelFor(static_cast<u32>(roots.size()), [&roots, last_version](u32 i)
+			{
+				UpdateRootChunk(*roots[i], last_version);
+			});
+
+			parent_rows_.clear();
+			for(u32 depth = 1; depth < levels_.size(); ++depth)
+			{
+				RecordParentRows(levels_[depth - 1], last_version);
+
+				const Vector<Chunk*>& level{ levels_[depth] };
+				world_->GetJobSystem().ParallelFor(static_cast<u32>(level.size()), [this, &level, last_version](u32 i)
+				{
+					UpdateChildChunk(*level[i], last_version);
+				});
+			}
+		}
+
+	protected:
+		// ForeachoRWorldQueryChunk𒼐ړǂݏ̂ŁASĐ錾Ă
+		void DeclareAccess() override
+		{
+			AddReadAccess<LocalTransform, Parent, HierarchyDepth, Children>();
+			AddWriteAccess<LocalToWorld>();
+		}
+
+	private:
+		// ς݂̐eLocalToWorld Execute̒ł̂ݗL
+		struct ParentRow
+		{
+			Entity entity_{};
+			const LocalToWorld* matrix_{};
+			bool is_changed_{};		// O̎sLocalToWorldύXꂽ
+		};
+
+		static XMMATRIX CalculateLocalMatrix(const LocalTransform& t)
+		{
+			const XMMATRIX S{ XMMatrixScaling(t.scale_.x, t.scale_.y, t.scale_.z) };
+			const XMMATRIX R{ XMMatrixRotationQuaternion(XMLoadFloat4(&t.rotation_)) };
+			const XMMATRIX T{ XMMatrixTranslation(t.position_.x, t.position_.y, t.position_.z) };
+			return S * R * T;
+		}
+
+		// [gChunkLocalTransformύXꂽꍇChunkŜvZ
+		static void UpdateRootChunk(Chunk& chunk, u32 last_version)
+		{
+			if(!IsNewerVersion(chunk.GetChangeVersion(GET_COMPONENT_ID(LocalTransform)), last_version)) return;
+
+			const std::span<const LocalTransform> transforms{ chunk.GetComponentSpan<const LocalTransform>() };
+			const std::span<LocalToWorld> world_matrices{ chunk.GetComponentSpan<LocalToWorld>() };
+			for(u32 i = 0; i < transforms.size(); ++i)
+			{
+				XMStoreFloat4x4(&world_matrices[i].matrix_, CalculateLocalMatrix(transforms[i]));
+			}
+		}
+
+		// ς݂̐[Chunk̂AChildrenEntitye̕\ɒǉ
+		// 󂢐[̋L^ĉŁAe̐[q2ȏ󂢏ꍇ\ǂݍ߂
+		void RecordParentRows(const Vector<Chunk*>& level, u32 last_version)
+		{
+			for(Chunk* chunk : level)
+			{
+				if(!chunk->HasComponent(GET_COMPONENT_ID(Children))) continue;
+
+				const bool is_changed{ IsNewerVersion(chunk->GetChangeVersion(GET_COMPONENT_ID(LocalToWorld)), last_version) };
+				const std::span<const LocalToWorld> world_matrices{ chunk->GetComponentSpan<const LocalToWorld>() };
+				const std::span<const Entity> entities{ chunk->GetEntities() };
+				for(u32 i = 0; i < entities.size(); ++i)
+				{
+					const EntityId id{ entities[i].GetId() };
+					if(id >= parent_slots_.size()) parent_slots_.resize(id + 1, std::numeric_limits<u32>::max());
+					parent_slots_[id] = static_cast<u32>(parent_rows_.size());
+					parent_rows_.emplace_back(ParentRow{ entities[i], &world_matrices[i], is_changed });
+				}
+			}
+		}
+
+		// e̕\entity̋L^T L^ĂȂꍇnullptr
+		// parent_slots_͑O̎s̒lcĂ̂ŁAL^EntityƔrĊmF
+		const ParentRow* FindParentRow(Entity entity) const
+		{
+			const EntityId id{ entity.GetId() };
+			if(id >= parent_slots_.size()) return nullptr;
+
+			const u32 slot{ parent_slots_[id] };
+			if(slot >= parent_rows_.size() || parent_rows_[slot].entity_ != entity) return nullptr;
+			return &parent_rows_[slot];
+		}
+
+		// eChunkEntityƂɐeLocalToWorldύXꂽ𔻒肷
+		// e̎q͓ChunkɘAĊi[Ă邱Ƃ̂ŁAO̐ěʂg܂킷
+		void UpdateChildChunk(Chunk& chunk, u32 last_version) const
+		{
+			const bool is_chunk_changed
+			{
+				IsNewerVersion(chunk.GetChangeVersion(GET_COMPONENT_ID(LocalTransform)), last_version) ||
+				IsNewerVersion(chunk.GetChangeVersion(GET_COMPONENT_ID(Parent)), last_version)
+			};
+
+			const std::span<const LocalTransform> transforms{ chunk.GetComponentSpan<const LocalTransform>() };
+			const std::span<const Parent> parents{ chunk.GetComponentSpan<const Parent>() };
+			std::span<LocalToWorld> world_matrices{};	// ނ܂Ŏ擾Ȃ 擾Ɨ̕ύXo[WXV
+
+			Entity cached_parent{};
+			bool is_parent_changed{};
+			bool is_parent_destroyed{};
+			XMMATRIX parent_matrix{};
+			for(u32 i = 0; i < parents.size(); ++i)
+			{
+				const Entity parent{ parents[i].parent_ };
+				if(parent != cached_parent)
+				{
+					cached_parent = parent;
+					is_parent_destroyed = false;
+					if(const ParentRow* row{ FindParentRow(parent) })
+					{
+						is_parent_changed = row->is_changed_;
+						parent_matrix = XMLoadFloat4x4(&row->matrix_->matrix_);
+					}
+					else if(world_->IsAlive(parent))
+					{
+						// LocalTransformȂeTransformSystemȂ̂Worldǂݍ
+						is_parent_changed = IsNewerVersion(world_->GetComponentChangeVersion<LocalToWorld>(parent), last_version);
+						const LocalToWorld parent_world{ world_->GetComponentData<LocalToWorld>(parent) };
+						parent_matrix = XMLoadFloat4x4(&parent_world.matrix_);
+					}
+					else
+					{
+						// e폜ꂽꍇ̓[gƂĈ
+						is_parent_changed = true;
+						is_parent_destroyed = true;
+						parent_matrix = XMMatrixIdentity();
+					}
+				}
+
+				// ̎s̓[gƂď悤ɂ qHierarchyDepth͐[܂܂Ae[Ԃ͕ۂ
+				if(is_parent_destroyed) GetEntityCommandBuffer().RemoveComponents<Parent, HierarchyDepth>(chunk.GetEntity(i));
+				if(!is_chunk_changed && !is_parent_changed) continue;
+
+				if(world_matrices.empty()) world_matrices = chunk.GetComponentSpan<LocalToWorld>();
+				XMStoreFloat4x4(&world_matrices[i].matrix_, CalculateLocalMatrix(transforms[i]) * parent_matrix);
+			}
+		}
+
+	private:
+		Vector<Vector<Chunk*>> levels_{};	// [Ƃ̏Chunk mۂȂ悤Ɏg܂킷
+		Vector<ParentRow> parent_rows_{};	// ς݂̐[ChildrenEntity mۂȂ悤Ɏg܂킷
+		Vector<u32> parent_slots_{};		// EntityIdIndexƂparent_rows_Index
+	};
+}
@@ -1,17 +1,655 @@
 #include "World.h"
 #include "System.h"
+#include "EntityCommandBuffer.h"
 
 
 namespace ecs
 {
-	World::World()
+	namespace
 	{
+		std::atomic<u64> world_serial_numbers{};
+		std::mutex entity_command_buffer_mutex{};	// entity_command_buffers_ւ̒ǉ̂ݎgp
+	}
+
+	World::World() : World(std::max(std::thread::hardware_concurrency(), 1u) - 1)
+	{
+	}
+
+	World::World(u32 worker_thread_counts, std::pmr::memory_resource* chunk_memory_resource)
+	{
+		if(!chunk_memory_resource)
+		{
+			chunk_pool_ = std::make_unique<ChunkPool>(Chunk::kChunkSize);
+			chunk_memory_resource = chunk_pool_.get();
+		}
+		chunk_memory_resource_ = chunk_memory_resource;
+
 		system_manager_ = std::make_unique<SystemManager>(this);
+		job_system_ = std::make_unique<JobSystem>(worker_thread_counts);
+		serial_number_ = ++world_serial_numbers;
+#if ECS_PROFILER_ENABLED
+		profiler_ = std::make_unique<SystemProfiler>(serial_number_);
+#endif
 	}
 
 	void World::ExecuteSystems()
 	{
 		system_manager_->Execute();
+		PlaybackEntityCommandBuffers();
+	}
+
+	EntityCommandBuffer& World::GetEntityCommandBuffer()
+	{
+		// World::serial_number_L[ƂXbhƂ̃obt@
+		thread_local UnorderedMap<u64, EntityCommandBuffer*> buffers{};
+
+		if(const auto it{ buffers.find(serial_number_) }; it != buffers.end()) return *it->second;
+
+		std::lock_guard lock{ entity_command_buffer_mutex };
+		EntityCommandBuffer* buffer{ entity_command_buffers_.emplace_back(std::make_unique<EntityCommandBuffer>()).get() };
+		buffers.insert({ serial_number_, buffer });
+		return *buffer;
+	}
+
+	void World::PlaybackEntityCommandBuffers()
+	{
+		for(const auto& buffer : entity_command_buffers_)
+		{
+			buffer->Playback(*this);
+		}
+	}
+
+	void World::Instantiate(Entity prefab, u32 counts, std::span<Entity> out)
+	{
+		_ASSERT_EXPR(IsAlive(prefab), L"폜ς݂Entity͕ł܂");
+		_ASSERT_EXPR(out.size() >= counts, L"out̑傫܂");
+
+		// Entity̍쐬Ŋi[ꏊ̕\Ċmۂ邱Ƃ̂ŐɃRs[Ă
+		// 悪vnuƓArchetypeStoragełAǉ͖ɍŝŃvnu̍s͈ړȂ
+		const EntityLocation location{ entity_manager_.GetLocation(prefab) };
+		const ComponentId prefab_id{ GET_COMPONENT_ID(Prefab) };
+		ArchetypeStorage* storage{ location.storage_->GetArchetype().Contains(prefab_id) ? GetRemoveComponentArchetypeStorage(*location.storage_, prefab_id) : location.storage_ };
+
+		const std::span<Entity> entities{ out.first(counts) };
+		entity_manager_.CreateEntities(entities);
+		storage->AddEntities(entities, entity_manager_, [&location](Chunk& chunk, u32 index, u32 chunk_counts)
+		{
+			chunk.CloneRow(index, chunk_counts, *location.chunk_, location.index_);
+		});
+	}
+
+	void World::RemoveEntities(std::span<const Entity> entities)
+	{
+		// i[ꏊEntityƂ1񂾂AoArchetypeStorage̔ԍUĐ
+		Vector<EntityLocation> locations{};
+		Vector<u32> storage_indices{};	// locationsƓԂArchetypeStorage̔ԍ
+		locations.reserve(entities.size());
+		storage_indices.reserve(entities.size());
+		Vector<ArchetypeStorage*> storages{};
+		Vector<u32> counts{};	// ArchetypeStorageƂ̍폜Entity̐
+		UnorderedMap<ArchetypeStorage*, u32> storage_map{};
+		u32 storage_index{};
+		for(const Entity entity : entities)
+		{
+			const EntityLocation& location{ entity_manager_.GetLocation(entity) };
+			if(storages.empty() || location.storage_ != storages[storage_index])
+			{
+				const auto [it, inserted]{ storage_map.try_emplace(location.storage_, static_cast<u32>(storages.size())) };
+				if(inserted)
+				{
+					storages.emplace_back(location.storage_);
+					counts.emplace_back(0);
+				}
+				storage_index = it->second;
+			}
+			++counts[storage_index];
+			storage_indices.emplace_back(storage_index);
+			locations.emplace_back(location);
+		}
+
+		// ArchetypeStorageɂ܂ꍇAグArchetypeStorageƂɕׂ
+		if(storages.size() > 1)
+		{
+			Vector<u32> offsets(counts.size());
+			std::exclusive_scan(counts.begin(), counts.end(), offsets.begin(), 0u);
+			Vector<EntityLocation> sorted(locations.size());
+			for(u64 i = 0; i < locations.size(); ++i) sorted[offsets[storage_indices[i]]++] = locations[i];
+			locations = std::move(sorted);
+		}
+
+		u64 begin{};
+		for(u64 i = 0; i < storages.size(); ++i)
+		{
+			storages[i]->RemoveEntities(std::span{ locations }.subspan(begin, counts[i]), entity_manager_);
+			begin += counts[i];
+		}
+
+		for(const Entity entity : entities)
+		{
+			entity_manager_.RemoveEntity(entity);
+		}
+	}
+
+	namespace
+	{
+		constexpr u64 AlignToPage(u64 size) { return (size + SnapshotHeader::kPageSize - 1) / SnapshotHeader::kPageSize * SnapshotHeader::kPageSize; }
+
+		// LoadœǂݍArchetypeStoragȅ
+		struct StorageRecord
+		{
+			struct ChunkRecord
+			{
+				u32 entity_counts_;
+				u64 blob_offset_;	// SnapshotHeader::blob_offset_̃ItZbg
+			};
+
+			Vector<ComponentId> component_ids_{};	// 
+			Vector<std::pair<u32, u32>> shared_values_{};	// LComponentComponent̕\ł̔ԍƒl̔ԍ
+			ChunkLayout layout_{};	// sComponentId̏ɕבւ
+			Vector<ChunkRecord> chunks_{};
+		};
+	}
+
+	WorldMemoryStats World::GetMemoryStats() const
+	{
+		WorldMemoryStats ret{};
+		ret.archetypes_.reserve(archetype_storages_.size());
+		for(const auto& [key, storage] : archetype_storages_)
+		{
+			const ArchetypeMemoryStats& stats{ ret.archetypes_.emplace_back(storage->GetMemoryStats()) };
+			ret.entity_counts_ += stats.entity_counts_;
+			ret.used_bytes_ += stats.used_bytes_;
+			ret.allocated_bytes_ += stats.allocated_bytes_;
+			ret.overhead_bytes_ += stats.overhead_bytes_;
+		}
+		ret.entity_map_bytes_ = entity_manager_.GetAllocatedBytes();
+
+		if(const ChunkPool* pool{ dynamic_cast<const ChunkPool*>(chunk_memory_resource_) })
+		{
+			const ChunkPool::Stats pool_stats{ pool->GetStats() };
+			ret.pool_reserved_bytes_ = pool_stats.reserved_bytes_;
+			ret.pool_free_bytes_ = pool_stats.free_bytes_;
+		}
+		return ret;
+	}
+
+	bool World::Compact(u32 max_chunk_moves)
+	{
+		for(const auto& [key, storage] : archetype_storages_)
+		{
+			storage->ShrinkToFit();
+		}
+
+		ChunkPool* pool{ dynamic_cast<ChunkPool*>(chunk_memory_resource_) };
+		if(!pool) return true;
+
+		pool->ReleaseFreeSlabs();
+		if(pool->PrepareEvacuation() == 0) return true;
+
+		// ޔΏۂ̃XuɂChunk̗̈ڂ ڂ͑ޔΏۂłȂXű󂫃ubNɂȂ
+		u32 move_counts{};
+		bool is_completed{ true };
+		for(const auto& [key, storage] : archetype_storages_)
+		{
+			for(const UniquePtr<Chunk>& chunk : storage->GetChunks())
+			{
+				if(!pool->IsEvacuating(chunk->GetBuffer().data())) continue;
+				if(move_counts == max_chunk_moves)
+				{
+					is_completed = false;
+					break;
+				}
+				chunk->Relocate();
+				++move_counts;
+			}
+			if(!is_completed) break;
+		}
+
+		pool->ReleaseFreeSlabs();
+		return is_completed;
+	}
+
+	bool World::WriteChromeTrace([[maybe_unused]] const std::filesystem::path& path) const
+	{
+#if ECS_PROFILER_ENABLED
+		std::ofstream file{ path, std::ios::trunc };
+		if(!file) return false;
+
+		profiler_->WriteChromeTrace(file);
+		return static_cast<bool>(file);
+#else
+		return false;
+#endif
+	}
+
+	bool World::Save(const std::filesystem::path& path) const
+	{
+		Vector<const ArchetypeStorage*> storages{};
+		Vector<ComponentId> component_ids{};
+		for(const auto& storage : archetype_storages_ | std::views::values)
+		{
+			storages.emplace_back(storage.get());
+			const std::span<const ComponentId> ids{ storage->GetArchetype().GetComponentIds() };
+			component_ids.insert(component_ids.end(), ids.begin(), ids.end());
+		}
+		std::ranges::sort(component_ids);
+		component_ids.erase(std::ranges::unique(component_ids).begin(), component_ids.end());
+
+		// t@CłComponentId̑Component̕\ł̔ԍgp
+		const auto component_index = [&component_ids](ComponentId id) { return static_cast<u32>(std::ranges::lower_bound(component_ids, id) - component_ids.begin()); };
+
+		SnapshotWriter writer{};
+
+		// Component̕\ ǂݍނƂɎs̃oCiƔzumF
+		writer.Write(static_cast<u32>(component_ids.size()));
+		for(const ComponentId id : component_ids)
+		{
+			_ASSERT_EXPR(ComponentTypeRegistry::IsTriviallyCopyable(id), L"grAɃRs[łȂComponent͕ۑł܂");
+			_ASSERT_EXPR(ComponentTypeRegistry::GetAlignment(id) <= SnapshotHeader::kPageSize, L"y[W傫ACgComponent͕ۑł܂");
+
+			writer.WriteString(ComponentTypeRegistry::GetName(id));
+			writer.Write(ComponentTypeRegistry::GetSize(id));
+			writer.Write(ComponentTypeRegistry::GetAlignment(id));
+			writer.Write(ComponentTypeRegistry::GetValueSize(id));
+			writer.Write(static_cast<u8>(ComponentTypeRegistry::IsEnableable(id)));
+			writer.Write(static_cast<u8>(ComponentTypeRegistry::IsShared(id)));
+
+			const std::span<const ComponentStream> streams{ ComponentTypeRegistry::GetStreams(id) };
+			writer.Write(static_cast<u32>(streams.size()));
+			writer.WriteBytes(streams.data(), streams.size_bytes());
+		}
+
+		// LComponent̒l ԍɂׂĕۑ
+		for(const ComponentId id : component_ids)
+		{
+			if(!ComponentTypeRegistry::IsShared(id)) continue;
+
+			const u32 value_counts{ shared_components_.GetValueCounts(id) };
+			writer.Write(value_counts);
+			for(u32 i = 0; i < value_counts; ++i)
+			{
+				writer.WriteBytes(shared_components_.GetValue(id, i), ComponentTypeRegistry::GetValueSize(id));
+			}
+		}
+
+		// Entity̕\ Entityidƃo[WۑƂƓɂ
+		const Vector<u32> versions{ entity_manager_.GetVersions() };
+		const std::span<const EntityId> free_entities{ entity_manager_.GetFreeEntities() };
+		writer.Write(static_cast<u32>(versions.size()));
+		writer.WriteBytes(versions.data(), versions.size() * sizeof(u32));
+		writer.Write(static_cast<u32>(free_entities.size()));
+		writer.WriteBytes(free_entities.data(), free_entities.size_bytes());
+
+		// ArchetypeStorage̕\ EntityێĂChunkۑ
+		u64 blob_size{};
+		writer.Write(static_cast<u32>(storages.size()));
+		for(const ArchetypeStorage* storage : storages)
+		{
+			const std::span<const ComponentId> ids{ storage->GetArchetype().GetComponentIds() };
+			writer.Write(static_cast<u32>(ids.size()));
+			for(const ComponentId id : ids) writer.Write(component_index(id));
+
+			const std::span<const SharedComponentValue> shared_values{ storage->GetSharedComponentValues() };
+			writer.Write(static_cast<u32>(shared_values.size()));
+			for(const SharedComponentValue& value : shared_values)
+			{
+				writer.Write(component_index(value.id_));
+				writer.Write(value.index_);
+			}
+
+			const ChunkLayout& layout{ storage->GetChunkLayout() };
+			writer.Write(layout.capacity_);
+			writer.Write(layout.buffer_size_);
+			writer.Write(layout.entity_offset_);
+			writer.Write(static_cast<u32>(layout.stream_offsets_.size()));
+			writer.WriteBytes(layout.stream_offsets_.data(), layout.stream_offsets_.size() * sizeof(u32));
+			writer.WriteBytes(layout.enabled_offsets_.data(), layout.enabled_offsets_.size() * sizeof(u32));
+
+			const Vector<UniquePtr<Chunk>>& chunks{ storage->GetChunks() };
+			writer.Write(static_cast<u32>(std::ranges::count_if(chunks, [](const UniquePtr<Chunk>& chunk) { return !chunk->IsEmpty(); })));
+			for(const UniquePtr<Chunk>& chunk : chunks)
+			{
+				if(chunk->IsEmpty()) continue;
+
+				writer.Write(chunk->GetEntityCounts());
+				writer.Write(blob_size);
+				blob_size += AlignToPage(layout.buffer_size_);
+			}
+		}
+
+		const std::span<const u8> metadata{ writer.GetData() };
+		const SnapshotHeader header{ SnapshotHeader::kMagic, SnapshotHeader::kVersion, Chunk::kChunkSize, metadata.size(), AlignToPage(sizeof(SnapshotHeader) + metadata.size()) };
+
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		if(!file) return false;
+
+		static constexpr std::array<char, SnapshotHeader::kPageSize> kPadding{};
+		file.write(reinterpret_cast<const char*>(&header), sizeof(SnapshotHeader));
+		file.write(reinterpret_cast<const char*>(metadata.data()), static_cast<std::streamsize>(metadata.size()));
+		file.write(kPadding.data(), static_cast<std::streamsize>(header.blob_offset_ - sizeof(SnapshotHeader) - metadata.size()));
+
+		// Chunk̃f[^̓y[WEɑĂ̂܂܏
+		for(const ArchetypeStorage* storage : storages)
+		{
+			for(const UniquePtr<Chunk>& chunk : storage->GetChunks())
+			{
+				if(chunk->IsEmpty()) continue;
+
+				const std::span<const u8> buffer{ chunk->GetBuffer() };
+				file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+				file.write(kPadding.data(), static_cast<std::streamsize>(AlignToPage(buffer.size()) - buffer.size()));
+			}
+		}
+
+		file.close();
+		return !file.fail();
+	}
+
+	bool World::Load(const std::filesystem::path& path)
+	{
+		if(!archetype_storages_.empty()) return false;
+
+		UniquePtr<MappedSnapshot> snapshot{ std::make_unique<MappedSnapshot>(path) };
+		const std::span<u8> data{ snapshot->GetData() };
+		if(data.size() < sizeof(SnapshotHeader)) return false;
+
+		SnapshotHeader header{};
+		std::memcpy(&header, data.data(), sizeof(SnapshotHeader));
+		if(header.magic_ != SnapshotHeader::kMagic || header.version_ != SnapshotHeader::kVersion || header.chunk_size_ != Chunk::kChunkSize) return false;
+		if(header.metadata_size_ > data.size() - sizeof(SnapshotHeader) || header.blob_offset_ % SnapshotHeader::kPageSize != 0 || header.blob_offset_ > data.size()) return false;
+
+		SnapshotReader reader{ data.subspan(sizeof(SnapshotHeader), header.metadata_size_) };
+		const std::span<u8> blobs{ data.subspan(header.blob_offset_) };
+
+		// Component̕\ OsComponentId߁AzuۑƂƓmF
+		Vector<ComponentId> component_ids(reader.ReadCounts());
+		Vector<u32> stream_counts(component_ids.size());
+		for(u64 i = 0; i < component_ids.size(); ++i)
+		{
+			const std::string_view name{ reader.ReadString() };
+			const u32 size{ reader.Read<u32>() };
+			const u32 alignment{ reader.Read<u32>() };
+			const u32 value_size{ reader.Read<u32>() };
+			const bool is_enableable{ reader.Read<u8>() != 0 };
+			const bool is_shared{ reader.Read<u8>() != 0 };
+			stream_counts[i] = reader.ReadCounts();
+			const std::span<const u8> streams{ reader.ReadBytes(stream_counts[i] * sizeof(ComponentStream)) };
+			if(reader.IsFailed()) return false;
+
+			const std::optional<ComponentId> id{ ComponentTypeRegistry::FindId(name) };
+			if(!id) return false;
+
+			const std::span<const ComponentStream> current_streams{ ComponentTypeRegistry::GetStreams(*id) };
+			if(size != ComponentTypeRegistry::GetSize(*id) || alignment != ComponentTypeRegistry::GetAlignment(*id) || value_size != ComponentTypeRegistry::GetValueSize(*id) ||
+				is_enableable != ComponentTypeRegistry::IsEnableable(*id) || is_shared != ComponentTypeRegistry::IsShared(*id) || !ComponentTypeRegistry::IsTriviallyCopyable(*id) ||
+				current_streams.size_bytes() != streams.size() || (!streams.empty() && std::memcmp(current_streams.data(), streams.data(), streams.size()) != 0))
+			{
+				return false;
+			}
+			component_ids[i] = *id;
+		}
+
+		// LComponent̒l
+		Vector<Vector<const u8*>> shared_values(component_ids.size());
+		for(u64 i = 0; i < component_ids.size(); ++i)
+		{
+			if(!ComponentTypeRegistry::IsShared(component_ids[i])) continue;
+
+			const u32 value_size{ ComponentTypeRegistry::GetValueSize(component_ids[i]) };
+			shared_values[i].resize(reader.ReadCounts());
+			for(const u8*& value : shared_values[i]) value = reader.ReadBytes(value_size).data();
+		}
+
+		// Entity̕\ǂݍ
+		Vector<u32> versions(reader.ReadCounts());
+		const std::span<const u8> version_bytes{ reader.ReadBytes(versions.size() * sizeof(u32)) };
+		Vector<EntityId> free_entities(reader.ReadCounts());
+		const std::span<const u8> free_entity_bytes{ reader.ReadBytes(free_entities.size() * sizeof(EntityId)) };
+		if(reader.IsFailed()) return false;
+		if(!versions.empty()) std::memcpy(versions.data(), version_bytes.data(), version_bytes.size());
+		if(!free_entities.empty()) std::memcpy(free_entities.data(), free_entity_bytes.data(), free_entity_bytes.size());
+
+		// ArchetypeStorage̕\ǂݍ
+		Vector<StorageRecord> storages(reader.ReadCounts());
+		for(StorageRecord& storage : storages)
+		{
+			// ۑƂComponentId̏ŕł̂ŁA̔zusComponentId̏ɕבւ
+			Vector<std::pair<ComponentId, u32>> components(reader.ReadCounts());
+			for(auto& [id, index] : components)
+			{
+				index = reader.Read<u32>();
+				if(index >= component_ids.size()) return false;
+				id = component_ids[index];
+			}
+
+			storage.shared_values_.resize(reader.ReadCounts());
+			for(auto& [index, value_index] : storage.shared_values_)
+			{
+				index = reader.Read<u32>();
+				value_index = reader.Read<u32>();
+				if(index >= component_ids.size() || value_index >= shared_values[index].size()) return false;
+			}
+
+			ChunkLayout& layout{ storage.layout_ };
+			layout.capacity_ = reader.Read<u32>();
+			layout.buffer_size_ = reader.Read<u32>();
+			layout.entity_offset_ = reader.Read<u32>();
+			Vector<u32> stream_offsets(reader.ReadCounts());
+			const std::span<const u8> stream_offset_bytes{ reader.ReadBytes(stream_offsets.size() * sizeof(u32)) };
+			Vector<u32> enabled_offsets(components.size());
+			const std::span<const u8> enabled_offset_bytes{ reader.ReadBytes(enabled_offsets.size() * sizeof(u32)) };
+			if(reader.IsFailed()) return false;
+			if(!stream_offsets.empty()) std::memcpy(stream_offsets.data(), stream_offset_bytes.data(), stream_offset_bytes.size());
+			if(!enabled_offsets.empty()) std::memcpy(enabled_offsets.data(), enabled_offset_bytes.data(), enabled_offset_bytes.size());
+
+			// ComponentƂ̗̐擪̔ԍ
+			Vector<u32> stream_begins(components.size() + 1);
+			for(u64 i = 0; i < components.size(); ++i) stream_begins[i + 1] = stream_begins[i] + stream_counts[components[i].second];
+			if(stream_begins.back() != stream_offsets.size()) return false;
+
+			Vector<u32> order(components.size());
+			std::iota(order.begin(), order.end(), 0u);
+			std::ranges::sort(order, {}, [&components](u32 i) { return components[i].first; });
+			for(const u32 i : order)
+			{
+				storage.component_ids_.emplace_back(components[i].first);
+				layout.stream_offsets_.insert(layout.stream_offsets_.end(), stream_offsets.begin() + stream_begins[i], stream_offsets.begin() + stream_begins[i + 1]);
+				layout.enabled_offsets_.emplace_back(enabled_offsets[i]);
+			}
+			if(std::ranges::adjacent_find(storage.component_ids_) != storage.component_ids_.end()) return false;
+			if(!Chunk::IsLayoutInBounds(layout, storage.component_ids_)) return false;
+
+			// Chunk̗eʂ͎s̊ŌvẐŁAۑƂ菭Ȃꍇ
+			const u32 capacity{ std::min(layout.capacity_, Chunk::CalculateCapacity(Archetype::Create(storage.component_ids_))) };
+			storage.chunks_.resize(reader.ReadCounts());
+			for(StorageRecord::ChunkRecord& chunk : storage.chunks_)
+			{
+				chunk.entity_counts_ = reader.Read<u32>();
+				chunk.blob_offset_ = reader.Read<u64>();
+				if(chunk.entity_counts_ > capacity || chunk.blob_offset_ > blobs.size() || layout.buffer_size_ > blobs.size() - chunk.blob_offset_) return false;
+			}
+			if(reader.IsFailed()) return false;
+		}
+
+		// ChunkɊi[ĂEntityEntity̕\ƈvĂ邩mF
+		// vĂȂRestoreChunkEntitẙi[ꏊݒłȂ̂ŁAWorldύXOɑSēǂݍŊmF
+		Vector<Entity> entities{};
+		for(const StorageRecord& storage : storages)
+		{
+			for(const StorageRecord::ChunkRecord& chunk : storage.chunks_)
+			{
+				if(chunk.entity_counts_ == 0) continue;
+				const u64 index{ entities.size() };
+				entities.resize(index + chunk.entity_counts_);
+				std::memcpy(entities.data() + index, &blobs[chunk.blob_offset_ + storage.layout_.entity_offset_], chunk.entity_counts_ * sizeof(Entity));
+			}
+		}
+		if(!EntityManager::IsRestorable(versions, free_entities, entities)) return false;
+
+		// WorldύX
+		entity_manager_.Restore(versions, free_entities);
+
+		Vector<Vector<SharedComponentValue>> restored_shared_values(component_ids.size());
+		for(u64 i = 0; i < component_ids.size(); ++i)
+		{
+			for(const u8* value : shared_values[i])
+			{
+				restored_shared_values[i].emplace_back(shared_components_.AddRaw(component_ids[i], value));
+			}
+		}
+
+		bool is_mapped{};
+		for(const StorageRecord& record : storages)
+		{
+			Vector<SharedComponentValue> values{};
+			for(const auto& [index, value_index] : record.shared_values_) values.emplace_back(restored_shared_values[index][value_index]);
+			std::ranges::sort(values, {}, &SharedComponentValue::id_);
+
+			ArchetypeStorage* storage{ GetOrAddArchetypeStorage(record.component_ids_, values) };
+			for(const StorageRecord::ChunkRecord& chunk : record.chunks_)
+			{
+				if(storage->RestoreChunk(&blobs[chunk.blob_offset_], *snapshot, record.layout_, chunk.entity_counts_, entity_manager_)) is_mapped = true;
+			}
+		}
+
+		// }bv̈̂܂܎gpĂChunkꍇێ
+		if(is_mapped) snapshots_.emplace_back(std::move(snapshot));
+		return true;
+	}
+
+	World::ArchetypeStoragePtr World::AddArchetypeStorage(Archetype archetype, Vector<SharedComponentValue> shared_values)
+	{
+		_ASSERT_EXPR(!archetype_storages_.contains(StorageKey{ archetype.GetArchetypeId(), archetype.GetComponentIds(), shared_values }), L"łɓo^ĂArchetypeł");
+
+		const ArchetypeStoragePtr storage = std::make_shared<ArchetypeStorage>(std::move(archetype), *chunk_memory_resource_, *change_version_, std::move(shared_values));
+		const Archetype& registered{ storage->GetArchetype() };
+		archetype_storages_.insert({ StorageKey{ registered.GetArchetypeId(), registered.GetComponentIds(), storage->GetSharedComponentValues() }, storage });
+
+		for(const auto& query : queries_)
+		{
+			if(query) query->AddArchetypeStorage(storage.get());
+		}
+		return storage;
+	}
+
+	ArchetypeStorage* World::GetOrAddArchetypeStorage(std::span<const ComponentId> component_ids, std::span<const SharedComponentValue> shared_values)
+	{
+		const auto it{ archetype_storages_.find(StorageKey{ Archetype::CreateArchetypeId(component_ids), component_ids, shared_values }) };
+		if(it != archetype_storages_.end()) return it->second.get();
+		return AddArchetypeStorage(Archetype::Create(component_ids), { shared_values.begin(), shared_values.end() }).get();
+	}
+
+	ArchetypeStorage* World::GetAddComponentArchetypeStorage(ArchetypeStorage& src, ComponentId id)
+	{
+		_ASSERT_EXPR(!ComponentTypeRegistry::IsShared(id), L"LComponentGetSharedComponentArchetypeStoragegpĂ");
+		if(ArchetypeStorage* dst{ src.GetAddEdge(id) }) return dst;
+
+		// ۂ܂id}VOl`쐬
+		const std::span<const ComponentId> src_ids{ src.GetArchetype().GetComponentIds() };
+		Vector<ComponentId> component_ids(src_ids.begin(), src_ids.end());
+		component_ids.insert(std::ranges::upper_bound(component_ids, id), id);
+
+		ArchetypeStorage* dst{ GetOrAddArchetypeStorage(component_ids, src.GetSharedComponentValues()) };
+		src.SetAddEdge(id, dst);
+		return dst;
+	}
+
+	ArchetypeStorage* World::GetRemoveComponentArchetypeStorage(ArchetypeStorage& src, ComponentId id)
+	{
+		if(ArchetypeStorage* dst{ src.GetRemoveEdge(id) }) return dst;
+
+		const std::span<const ComponentId> src_ids{ src.GetArchetype().GetComponentIds() };
+		Vector<ComponentId> component_ids(src_ids.begin(), src_ids.end());
+		std::erase(component_ids, id);
+
+		if(ComponentTypeRegistry::IsShared(id))
+		{
+			// LComponent̒ǉ͒lɂĈړ悪ς̂ŁA폜̈ړ悾LbV
+			Vector<SharedComponentValue> shared_values{};
+			std::ranges::copy_if(src.GetSharedComponentValues(), std::back_inserter(shared_values), [id](const SharedComponentValue& value) { return value.id_ != id; });
+
+			ArchetypeStorage* dst{ GetOrAddArchetypeStorage(component_ids, shared_values) };
+			src.SetRemoveEdge(id, dst);
+			return dst;
+		}
+
+		// 폜Archetypeidǉړ悪gɂȂ̂ŁAǉ̈ړƂĐݒ肷ΗLbV
+		ArchetypeStorage* dst{ GetOrAddArchetypeStorage(component_ids, src.GetSharedComponentValues()) };
+		dst->SetAddEdge(id, &src);
+		return dst;
+	}
+
+	ArchetypeStorage* World::GetAddComponentsArchetypeStorage(ArchetypeStorage& src, std::span<const ComponentId> ids, std::span<const SharedComponentValue> shared_values)
+	{
+		const std::span<const ComponentId> src_ids{ src.GetArchetype().GetComponentIds() };
+		Vector<ComponentId> component_ids(src_ids.begin(), src_ids.end());
+		for(const ComponentId id : ids) component_ids.insert(std::ranges::upper_bound(component_ids, id), id);
+
+		const std::span<const SharedComponentValue> src_values{ src.GetSharedComponentValues() };
+		Vector<SharedComponentValue> values(src_values.begin(), src_values.end());
+		values.insert(values.end(), shared_values.begin(), shared_values.end());
+		std::ranges::sort(values, {}, &SharedComponentValue::id_);
+
+		return GetOrAddArchetypeStorage(component_ids, values);
+	}
+
+	ArchetypeStorage* World::GetRemoveComponentsArchetypeStorage(ArchetypeStorage& src, std::span<const ComponentId> ids)
+	{
+		const auto is_kept = [ids](ComponentId id) { return std::ranges::find(ids, id) == ids.end(); };
+
+		Vector<ComponentId> component_ids{};
+		std::ranges::copy_if(src.GetArchetype().GetComponentIds(), std::back_inserter(component_ids), is_kept);
+
+		Vector<SharedComponentValue> shared_values{};
+		std::ranges::copy_if(src.GetSharedComponentValues(), std::back_inserter(shared_values), [&is_kept](const SharedComponentValue& value) { return is_kept(value.id_); });
+
+		return GetOrAddArchetypeStorage(component_ids, shared_values);
+	}
+
+	ArchetypeStorage* World::GetSharedComponentArchetypeStorage(ArchetypeStorage& src, const SharedComponentValue& shared_value)
+	{
+		const ComponentId id{ shared_value.id_ };
+		const std::span<const ComponentId> src_ids{ src.GetArchetype().GetComponentIds() };
+		Vector<ComponentId> component_ids(src_ids.begin(), src_ids.end());
+		if(!src.GetArchetype().Contains(id)) component_ids.insert(std::ranges::upper_bound(component_ids, id), id);
+
+		// ۂ܂ܒlu(܂͑})
+		const std::span<const SharedComponentValue> src_values{ src.GetSharedComponentValues() };
+		Vector<SharedComponentValue> shared_values(src_values.begin(), src_values.end());
+		const auto it{ std::ranges::lower_bound(shared_values, id, {}, &SharedComponentValue::id_) };
+		if(it != shared_values.end() && it->id_ == id) *it = shared_value;
+		else shared_values.insert(it, shared_value);
+
+		return GetOrAddArchetypeStorage(component_ids, shared_values);
+	}
+
+	u64 World::StorageKeyHash::operator()(const StorageKey& key) const
+	{
+		// ArchetypeId̑ƂċLComponentIDƒl̔ԍFNV-1aō
+		u64 hash{ key.archetype_id_ };
+		for(const SharedComponentValue& value : key.shared_values_)
+		{
+			const u64 bits{ static_cast<u64>(value.id_) << 32 | value.index_ };
+			for(u32 i = 0; i < sizeof(u64); ++i)
+			{
+				hash ^= (bits >> (i * 8)) & 0xff;
+				hash *= 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
+	bool World::IsSameSharedComponentValues(std::span<const SharedComponentValue> lhs, std::span<const SharedComponentValue> rhs)
+	{
+		return std::ranges::equal(lhs, rhs, [](const SharedComponentValue& l, const SharedComponentValue& r) { return l.id_ == r.id_ && l.index_ == r.index_; });
+	}
+
+	void World::InitializeQuery(QueryBase& query) const
+	{
+		for(const auto& storage : archetype_storages_ | std::views::values)
+		{
+			query.AddArchetypeStorage(storage.get());
+		}
 	}
 
 }
@@ -5,18 +5,46 @@
 #include "Archetype.h"
 #include "Entity.h"
 #include "Chunk.h"
+#include "ArchetypeStorage.h"
+#include "ChunkPool.h"
+#include "SharedComponentStore.h"
+#include "Query.h"
+#include "JobSystem.h"
+#include "WorldSnapshot.h"
+#include "Profiler.h"
 
 
 namespace ecs
 {
 	class SystemBase;
 	class SystemManager;
+	class EntityCommandBuffer;
+
+	// World::GetMemoryStats̖߂l
+	struct WorldMemoryStats
+	{
+		Vector<ArchetypeMemoryStats> archetypes_{};	// ArchetypeStorage LComponent̒lقȂ͕̂ʁXɏWv
+		u32 entity_counts_{};
+		u64 used_bytes_{};			// archetypes_̍v
+		u64 allocated_bytes_{};		// archetypes_̍v
+		u64 overhead_bytes_{};		// archetypes_̍v
+		u64 entity_map_bytes_{};	// EntityManager̕\mۂĂTCY 폜Entityid̕܂
+		u64 pool_reserved_bytes_{};	// ChunkPoolmۂĂXu̍v ChunkPoolȊÕ\[XgpĂꍇ0
+		u64 pool_free_bytes_{};		// ChunkPool̋󂫃ubN̍v WorldƋLĂꍇ͑World̕܂
+	};
 
 	class World
 	{
-		using ChunkPtr = SharedPtr<Chunk>;
+		friend class EntityCommandBuffer;
+		friend class SystemManager;
+		using ArchetypeStoragePtr = SharedPtr<ArchetypeStorage>;
 	public:
 		World();
+		// worker_thread_counts JobSystem̃[J[Xbh̐
+		// chunk_memory_resource Chunk̃̊mۂɎgp郁\[X World蒷ĂȂ΂ȂȂ
+		//                       nullptȑꍇWorld쐬ChunkPoolgp
+		//                       q[Wy[WgpꍇWorldԂŃubNLꍇChunkPool쐬ēn
+		explicit World(u32 worker_thread_counts, std::pmr::memory_resource* chunk_memory_resource = nullptr);
 		~World() = default;
 
 		World(const World&) = delete;
@@ -25,67 +53,330 @@ namespace ecs
 		World(World&&) = default;
 		World& operator=(World&&) = default;
 
+		// SystemׂĎsAsɋL^ꂽEntityCommandBuffer̃R}h܂Ƃ߂Ďs
 		void ExecuteSystems();
 
+		// ĂяoXbhpEntityCommandBuffer擾
+		// XbhƂɕʂ̃obt@蓖Ă̂ŁAɎsSystem烍bNȂŋL^ł
+		// L^R}hExecuteSystems̍ŌA܂PlaybackEntityCommandBuffersł܂Ƃ߂Ďs
+		EntityCommandBuffer& GetEntityCommandBuffer();
+
+		// SXbhEntityCommandBufferɋL^ꂽR}hs(|Cg)
+		// System̎sɌĂ΂Ȃ
+		void PlaybackEntityCommandBuffers();
+
+		// SĂEntityComponent̃f[^t@Cɕۑ
+		// ComponentComponentIdł͂ȂGetTypeName̖Oŕۑ̂ŁAComponentId̊蓖ďقȂsłǂݍ߂
+		// eChunk̃f[^EntityƂɕϊɁAy[WEɑChunk::GetBuffer̂܂܏
+		// Componentׂ͂ăgrAɃRs[\łȂ΂ȂȂ Entity͂̂܂ܕۑ̂ŁAComponentێEntityǂݍ݌ɗL
+		// ߂l t@Cɏ߂Ȃꍇfalse
+		bool Save(const std::filesystem::path& path) const;
+
+		// Saveŕۑt@CEntityComponent̃f[^𕜌
+		// t@C̓Ƀ}bvAChunk̔zułEntityƂ̕ϊRs[Ƀ}bv̈̂܂ChunkƂĎgp
+		// zuقȂꍇ(ComponentId̊蓖ďقȂꍇȂ)͗񂲂ƂɃRs[
+		// Archetype1o^ĂȂWorldɑ΂Ă̂ݓǂݍ߂
+		// t@CɊ܂܂Componenť^͎OAddArchetypeGET_COMPONENT_IDȂǂňxo^Ă
+		// ߂l Archetypeo^ς݂World̏ꍇAt@Cǂݍ߂ȂeĂꍇAComponento^ĂȂꍇA
+		//        ܂Component̃TCYACgۑƂƈقȂꍇfalse falsȅꍇWorld͕ύXȂ
+		bool Load(const std::filesystem::path& path);
+
+		// ArchetypeStorageƂEntity̐AeʁAgpĂ郁ƊmۂĂ郁Wv
+		WorldMemoryStats GetMemoryStats() const;
+
+		// Entity̑ʂ̍폜ȂǂŎgȂȂ
+		// EntityێĂȂArchetypeStoragecĂChunkA
+		// ChunkPoolgpĂꍇ͎gp̒ႢXuChunk̗̈𑼂̃Xű󂫃ubNɈڂāA󂢂Xu
+		// ړChunk̐𐧌ł̂ŁAtrueԂ܂Ńt[ƂɌĂяoΏ𕡐̃t[ɕ
+		// Chunk͗̈悾ڂ̂Entitẙi[ꏊ͕ςȂA擾ς݂ComponentArrayChunkView͖ɂȂ
+		// System̎sɌĂ΂Ȃ
+		// max_chunk_moves 1̌Ăяoŗ̈ڂChunk̍ő吔
+		// ߂l ڂChunkcĂȂꍇtrue
+		bool Compact(u32 max_chunk_moves = std::numeric_limits<u32>::max());
+
+		// frame_countst[SystemƂ̎s(ŏAρA99p[Z^C)Əʂ̕
+		// ECS_PROFILER_ENABLED0̏ꍇ͏ɋ System̎sɌĂ΂Ȃ
+		Vector<SystemProfileSummary> GetSystemProfileSummaries([[maybe_unused]] u32 frame_counts = SystemProfiler::kDefaultSummaryFrames) const
+		{
+#if ECS_PROFILER_ENABLED
+			return profiler_->GetSummaries(frame_counts);
+#else
+			return {};
+#endif
+		}
+
+		// L^ɎcĂSystem̎sChromẽg[XCxg`(JSON)Ńt@Cɏ
+		// System̎sɌĂ΂Ȃ
+		// ߂l t@Cɏ߂ȂꍇECS_PROFILER_ENABLED0̏ꍇfalse
+		bool WriteChromeTrace(const std::filesystem::path& path) const;
+
 		// Archetype̒ǉ ev[gChunkɕێComponentw肷
-		// łɓR|[lgێĂChunkƂ͂Chunk̃|C^[Ԃ
+		// łɓR|[lgێĂArchetypeƂ͂ArchetypeIDԂ
+		// LComponent͊lArchetypeStorage쐬
 		// ...Components ChunkɕێComponent
 		template<class ...Components>
 		ArchetypeId AddArchetype()
 		{
-			// SComponentsێĂChunkȂmF
-			for(const auto& chunk : chunks_)
-			{
-				if(chunk.second->IsSame<Components...>()) return chunk.first;
-			}
-
-			const ChunkPtr chunk = std::make_shared<Chunk>(Chunk::Create<Components...>(100));
-			chunks_[chunk->GetArchetype().GetArchetypeId()] = chunk;
-			return chunk->GetArchetype().GetArchetypeId();
+			return GetOrAddArchetypeStorage<Components...>(CreateSharedComponentValues<Components...>(static_cast<const Components*>(nullptr)...))->GetArchetype().GetArchetypeId();
 		}
 
 		// Entity̒ǉ
-		// ǉꂽComponent̃f[^͖` TODO ǉꂽComponent̏@ɂčl
+		// ǉꂽComponent̓ftHg\z grAɃftHg\złComponent̃f[^͖` LComponent͊lɂȂ
+		// lꍇAddEntity(values...)gpƁASetComponentDataŏݒɍς
 		// ...Components EntityɎComponents
 		template<class ...Components>
 		[[nodiscard]] Entity AddEntity()
 		{
 			const Entity entity{ entity_manager_.CreateEntity() };
 
-			// w肳ꂽComponentsƑSComponensێĂChunkȂmF
-			ChunkPtr chunk{ GetSameChunk<Components...>() };
-			
-			if(!chunk) chunk = AddChunk<Components...>();
-			chunk->AddEntity(entity);
+			// w肳ꂽComponentsƑSComponensێĂArchetypeStorage擾 Ȃꍇ͍쐬
+			ArchetypeStorage* storage{ GetOrAddArchetypeStorage<Components...>(CreateSharedComponentValues<Components...>(static_cast<const Components*>(nullptr)...)) };
+			storage->AddEntity(entity, entity_manager_);
+			return entity;
+		}
 
-			const ArchetypeId archetype_id{ chunk->GetArchetype().GetArchetypeId() };
-			entity_archetype_map_.insert({ entity, archetype_id });
+		// EntityǉAComponent̃f[^̒lŏ
+		// ArchetypeStoragě1񂾂ŁAeComponent͒ǉsɒڍ\z EӒlœnComponent̓[u
+		// LComponent͂̒lArchetypeStorageɒǉ
+		//  const Entity entity{ world.AddEntity(LocalTransform{}, LocalToWorld{}) };
+		// values EntityɎComponent̒l ^͈琄_̂Ńev[g͎w肵Ȃ
+		template<class ...Components> requires(sizeof...(Components) > 0)
+		[[nodiscard]] Entity AddEntity(Components&&... values)
+		{
+			static_assert(!IsArgsHasSameType<Components...>(), "R|[lgw肳Ă܂");
+
+			const Entity entity{ entity_manager_.CreateEntity() };
+			ArchetypeStorage* storage{ GetOrAddArchetypeStorage<std::remove_cvref_t<Components>...>(CreateSharedComponentValues<std::remove_cvref_t<Components>...>(&values...)) };
+			storage->AddEntity(entity, entity_manager_, std::forward<Components>(values)...);
 			return entity;
 		}
 
+		// Entity܂Ƃ߂Ēǉ
+		// Chunk̊mۂ͈xsAEntity͘AsɊi[
+		// ǉꂽComponent̃f[^͖` LComponent͊lɂȂ
+		// ...Components EntityɎComponents
+		// counts ǉEntity̐
+		// out ǉEntity̏ݐ countsȏ̑傫Kv
+		template<class ...Components>
+		void AddEntities(u32 counts, std::span<Entity> out)
+		{
+			AddEntitiesImpl<Components...>(counts, out, CreateSharedComponentValues<Components...>(static_cast<const Components*>(nullptr)...), [](Chunk& chunk, u32 index, u32 chunk_counts)
+			{
+				chunk.ConstructRows(index, chunk_counts);
+			});
+		}
+
+		// Entity܂Ƃ߂ĒǉAComponent̃f[^vg^Cv̒lRs[\z
+		// \z͗񂲂Ƃɂ܂Ƃ߂čs LComponent͂̒lArchetypeStorageɒǉ
+		// counts ǉEntity̐
+		// out ǉEntity̏ݐ countsȏ̑傫Kv
+		// prototypes eComponent̏l
+		template<class ...Components>
+		void AddEntities(u32 counts, std::span<Entity> out, const Components&... prototypes)
+		{
+			AddEntitiesImpl<Components...>(counts, out, CreateSharedComponentValues<Components...>(&prototypes...), [&prototypes...](Chunk& chunk, u32 index, u32 chunk_counts)
+			{
+				([&chunk, index, chunk_counts](const auto& prototype)
+				{
+					using Component = std::remove_cvref_t<decltype(prototype)>;
+					chunk.ConstructComponentData<Component>(index, chunk_counts, prototype);
+				}(prototypes), ...);
+			});
+		}
+
+		// vnuEntity𕡐
+		// Entity̓vnuPrefabArchetype(LComponent̒l)̘AsɊi[
+		// Component̃f[^ƗL/͗񂲂Ƃɂ܂Ƃ߂ăRs[(Chunk::CloneRow)
+		// prefab Entity ʏPrefabێĂEntity PrefabێĂȂꍇ͓Archetypeɕ
+		// counts 鐔
+		// out Entity̏ݐ countsȏ̑傫Kv
+		void Instantiate(Entity prefab, u32 counts, std::span<Entity> out);
+
+		// Entity܂Ƃ߂č폜
+		// ArchetypeStorageƂɂ܂Ƃ߁ASĂ̍s폜ChunkChunkƉAč͖̍s1̑Ŗ߂
+		// entities 폜entity d͕s
+		void RemoveEntities(std::span<const Entity> entities);
+
 		// Entity̍폜
 		// entity 폜entity
 		void RemoveEntity(Entity entity)
 		{
-			const ArchetypeId archetype_id{ entity_archetype_map_.at(entity) };
-			const ChunkPtr chunk{ chunks_.at(archetype_id) };
-			chunk->RemoveEntity(entity);
-			const auto it{ entity_archetype_map_.find(entity) };
-			entity_archetype_map_.erase(it);
+			ArchetypeStorage* storage{ entity_manager_.GetLocation(entity).storage_ };
+			storage->RemoveEntity(entity, entity_manager_);
 			entity_manager_.RemoveEntity(entity);
 		}
 
 
+		// EntityComponentǉ
+		// Entity͒ǉArchetypeɈړAComponent̃f[^͈p EntityID͕ςȂ
+		// Component ǉComponenť^ łɕێĂ^͎włȂ
+		// entity ComponentǉEntity
+		// data ǉComponent̃f[^ LComponent̏ꍇ͂̒lArchetypeStorageɈړ
+		template<class Component>
+		void AddComponent(Entity entity, const Component& data)
+		{
+			const ComponentId id{ GET_COMPONENT_ID(Component) };
+			ArchetypeStorage* src{ entity_manager_.GetLocation(entity).storage_ };
+			_ASSERT_EXPR(!src->GetArchetype().Contains(id), L"łɕێĂComponentǉ悤ƂȂł");
+
+			if constexpr(SharedComponent<Component>)
+			{
+				ArchetypeStorage* dst{ GetSharedComponentArchetypeStorage(*src, shared_components_.Add(data)) };
+				src->MoveEntity(entity, *dst, entity_manager_);
+			}
+			else
+			{
+				ArchetypeStorage* dst{ GetAddComponentArchetypeStorage(*src, id) };
+				src->MoveEntity(entity, *dst, entity_manager_, data);
+			}
+		}
+
+		// EntityComponent폜
+		// Entity͍폜ArchetypeɈړAcComponent̃f[^͈p EntityID͕ςȂ
+		// Component 폜Componenť^
+		// entity Component폜Entity
+		template<class Component>
+		void RemoveComponent(Entity entity)
+		{
+			const ComponentId id{ GET_COMPONENT_ID(Component) };
+			ArchetypeStorage* src{ entity_manager_.GetLocation(entity).storage_ };
+			_ASSERT_EXPR(src->GetArchetype().Contains(id), L"ێĂȂComponent폜悤ƂȂł");
+
+			ArchetypeStorage* dst{ GetRemoveComponentArchetypeStorage(*src, id) };
+			src->MoveEntity(entity, *dst, entity_manager_);
+		}
+
+		// EntityComponent܂Ƃ߂Ēǉ
+		// ǉArchetypeStorage͈xAEntitÿړ1ōς Component̃f[^͈p
+		// ...Components ǉComponenť^ łɕێĂ^͎włȂ
+		// entity ComponentǉEntity
+		// values ǉComponent̃f[^ LComponent͂̒lArchetypeStorageɈړ
+		template<class ...Components>
+		void AddComponents(Entity entity, const Components&... values)
+		{
+			static_assert(!IsArgsHasSameType<Components...>(), "R|[lgw肳Ă܂");
+			ArchetypeStorage* src{ entity_manager_.GetLocation(entity).storage_ };
+			_ASSERT_EXPR(!(src->GetArchetype().Contains(GET_COMPONENT_ID(Components)) || ...), L"łɕێĂComponentǉ悤ƂȂł");
+
+			const std::array<ComponentId, sizeof...(Components)> ids{ GET_COMPONENT_ID(Components)... };
+			Vector<SharedComponentValue> shared_values{};
+			([this, &shared_values](const auto& value)
+			{
+				if constexpr(SharedComponent<std::remove_cvref_t<decltype(value)>>) shared_values.emplace_back(shared_components_.Add(value));
+			}(values), ...);
+
+			ArchetypeStorage* dst{ GetAddComponentsArchetypeStorage(*src, ids, shared_values) };
+			src->MoveEntity(entity, *dst, entity_manager_, values...);
+		}
+
+		// EntityComponent܂Ƃ߂č폜
+		// 폜ArchetypeStorage͈xAEntitÿړ1ōς cComponent̃f[^͈p
+		// ...Components 폜Componenť^
+		// entity Component폜Entity
+		template<class ...Components>
+		void RemoveComponents(Entity entity)
+		{
+			ArchetypeStorage* src{ entity_manager_.GetLocation(entity).storage_ };
+			_ASSERT_EXPR((src->GetArchetype().Contains(GET_COMPONENT_ID(Components)) && ...), L"ێĂȂComponent폜悤ƂȂł");
+
+			const std::array<ComponentId, sizeof...(Components)> ids{ GET_COMPONENT_ID(Components)... };
+			ArchetypeStorage* dst{ GetRemoveComponentsArchetypeStorage(*src, ids) };
+			src->MoveEntity(entity, *dst, entity_manager_);
+		}
+
+		// EntityComponentێĂ邩
+		template<class Component>
+		bool HasComponent(Entity entity) const
+		{
+			return entity_manager_.GetLocation(entity).storage_->GetArchetype().Contains<Component>();
+		}
+
+		// EntityL(폜ĂȂ)
+		bool IsAlive(Entity entity) const { return entity_manager_.IsAlive(entity); }
+
 		// Component̃f[^Zbg
-		// Component ZbgComponenť^
+		// Component ZbgComponenť^ LComponent̏ꍇSetSharedComponentƓ
 		// entity ̃R|[lgێĂEntityID
 		// data Zbgf[^
 		template<class Component>
 		void SetComponentData(Entity entity, const Component& data)
 		{
-			const ArchetypeId archetype_id{ entity_archetype_map_.at(entity) };
-			const ChunkPtr chunk{ chunks_.at(archetype_id) };
-			chunk->SetComponentData<Component>(entity, data);
+			if constexpr(SharedComponent<Component>)
+			{
+				SetSharedComponent<Component>(entity, data);
+			}
+			else
+			{
+				const EntityLocation& location{ entity_manager_.GetLocation(entity) };
+				location.chunk_->SetComponentData<Component>(location.index_, data);
+			}
+		}
+
+		// LComponent̒lύX
+		// LComponent̒lƂArchetypeStorageĂ̂ŁAlςꍇEntity͕ʂArchetypeStorageɈړ
+		// Component ComponentSharedꉻĂComponenť^
+		// entity ̃R|[lgێĂEntityID
+		// value Vl
+		template<class Component>
+		void SetSharedComponent(Entity entity, const Component& value)
+		{
+			static_assert(SharedComponent<Component>, "ComponentSharedꉻĂȂComponentł");
+
+			const EntityLocation& location{ entity_manager_.GetLocation(entity) };
+			const SharedComponentValue shared_value{ shared_components_.Add(value) };
+			if(location.chunk_->GetSharedComponentIndex(shared_value.id_) == shared_value.index_) return;
+
+			ArchetypeStorage* src{ location.storage_ };
+			ArchetypeStorage* dst{ GetSharedComponentArchetypeStorage(*src, shared_value) };
+			src->MoveEntity(entity, *dst, entity_manager_);
+		}
+
+		// LComponent̒l擾
+		// ߂l Worldj܂ŗL
+		template<class Component>
+		const Component& GetSharedComponent(Entity entity) const
+		{
+			const EntityLocation& location{ entity_manager_.GetLocation(entity) };
+			return location.chunk_->GetSharedComponent<Component>();
+		}
+
+		// LComponent̒l̔ԍ(SharedComponentValue::index_)擾
+		// ߂l ̒lEntityxĂȂꍇstd::nullopt
+		template<class Component>
+		std::optional<u32> FindSharedComponentIndex(const Component& value) const
+		{
+			return shared_components_.Find(value);
+		}
+
+		// Component̗L/؂ւ
+		// Archetype͕ςȂ̂Entitÿړ͔AComponentArrayȂǂɂȂȂ
+		// ɂComponentێĂEntityForeachAParallelForeachŌĂяoȂȂ
+		// قȂEntityłΕ̃Xbh瓯ɌĂł悢 SystemĂԏꍇAddWriteAccessŏ݂L^邱
+		// Component ComponentEnableableꉻĂComponenť^
+		template<class Component>
+		void SetComponentEnabled(Entity entity, bool enabled)
+		{
+			static_assert(EnableableComponent<Component>, "ComponentEnableableꉻĂȂComponentł");
+			const EntityLocation& location{ entity_manager_.GetLocation(entity) };
+			location.chunk_->SetComponentEnabled(GET_COMPONENT_ID(Component), location.index_, enabled);
+		}
+
+		// Entityi[ĂChunkComponent̗̕ύXo[W(Chunk::GetChangeVersion)擾
+		// ʂEntityComponentOSystem̎sȍ~ɕύXꂽ𔻒肷ꍇȂǂɎgp
+		// ChunkPʂȂ̂ŁAChunk̑EntityύXꂽꍇVo[WɂȂ
+		template<class Component>
+		u32 GetComponentChangeVersion(Entity entity) const
+		{
+			const EntityLocation& location{ entity_manager_.GetLocation(entity) };
+			return location.chunk_->GetChangeVersion(GET_COMPONENT_ID(Component));
+		}
+
+		// ComponentL ComponentEnableableꉻĂȂComponent͏ɗL
+		template<class Component>
+		bool IsComponentEnabled(Entity entity) const
+		{
+			const EntityLocation& location{ entity_manager_.GetLocation(entity) };
+			return location.chunk_->IsComponentEnabled(GET_COMPONENT_ID(Component), location.index_);
 		}
 
 		// Component̃f[^擾
@@ -94,9 +385,8 @@ namespace ecs
 		template<class Component>
 		Component GetComponentData(Entity entity)
 		{
-			const ArchetypeId archetype_id{ entity_archetype_map_.at(entity) };
-			const ChunkPtr chunk{ chunks_.at(archetype_id) };
-			return chunk->GetComponentData<Component>(entity);
+			const EntityLocation& location{ entity_manager_.GetLocation(entity) };
+			return location.chunk_->GetComponentData<Component>(location.index_);
 		}
 
 		// ComponentArray̔z擾 w肳ꂽSComponentԂ
@@ -107,66 +397,198 @@ namespace ecs
 		Vector<ComponentArray<T>> GetComponentArrays()
 		{
 			Vector<ComponentArray<T>> arrays;
-			for(const auto& chunk : chunks_ | std::views::values)
+			GetQuery<T>().ForeachChunk([&arrays](Chunk& chunk)
 			{
-				if(chunk->Contains<T>())
-				{
-					arrays.emplace_back(chunk->GetComponentArray<T>());
-				}
-			}
+				arrays.emplace_back(chunk.GetComponentArray<T>());
+			});
 			return arrays;
 		}
 
-		template<class ...Components>
-		Vector<ChunkPtr> GetChunkList()
+		// w肳ꂽ𖞂ArchetypeEntityi[ĂChunk̃Xg擾
+		// ...Terms QueryƓ Componenť^̑With, Without, Any, Optionalwł
+		//  : GetComponentArraysƓlEntity̒ǉ폜ɂChunk\̂ŕێȂ
+		template<class ...Terms>
+		Vector<Chunk*> GetChunkList()
+		{
+			Vector<Chunk*> ret{};
+			GetQuery<Terms...>().ForeachChunk([&ret](Chunk& chunk) { ret.emplace_back(&chunk); });
+			return ret;
+		}
+
+		// w肳ꂽ𖞂ArchetypeStorageNG擾
+		// ߂Ď擾Ƃɍ쐬Aȍ~Archetype̒ǉɍ킹čXVꑱ
+		// ߂lWorldj܂ŗLȂ̂ŁASystemȂǂŕێĎg܂킵Ă悢
+		// ɎsSystem瓯ɌĂ΂Ă悢悤ɁAqueries_̎QƂƍ쐬̓bN
+		template<class ...Terms>
+		Query<Terms...>& GetQuery()
 		{
-			Vector<ChunkPtr> ret{};
-			for(auto& chunk : chunks_ | std::views::values)
+			const u32 id{ TypeIndexRegistry<QueryBase>::GetId<Query<Terms...>>() };
+			std::lock_guard lock{ *query_mutex_ };
+			if(id >= queries_.size()) queries_.resize(id + 1);
+
+			UniquePtr<QueryBase>& query{ queries_[id] };
+			if(!query)
 			{
-				if(chunk->Contains<Components...>()) ret.emplace_back(chunk);
+				query = std::make_unique<Query<Terms...>>();
+				InitializeQuery(*query);
 			}
-			return ret;
+			return static_cast<Query<Terms...>&>(*query);
 		}
 
 		SystemManager* GetSystemManager() const { return system_manager_.get(); }
+		JobSystem& GetJobSystem() const { return *job_system_; }
+#if ECS_PROFILER_ENABLED
+		SystemProfiler& GetProfiler() const { return *profiler_; }
+#endif
+
+		// ݂̕ύXo[W
+		// Chunk̗ɏ܂ꂽƂɋL^ASystemChanged<T>Added<T>őO̎sȍ~ɕύXꂽChunk𔻒肷̂Ɏgp
+		// SystemManagerSystemsOƁAׂĂSystemsɐi߂
+		u32 GetChangeVersion() const { return *change_version_; }
 
 	private:
 
-		// gp̂ AddArchetype()̖߂lChunkPtrɕς
-		// O璼ChunkɐGĂقȂAłArhcetype̒ǉƓChunkgp邱Ƃ邽
-		// gp݂̂ō쐬
-		template<class ...Components>
-		ChunkPtr AddChunk()
+		// ύXo[Wi߂ 0́uxsĂȂv\̂ŎgpȂ
+		// ߂l i߂̕ύXo[W
+		u32 AdvanceChangeVersion()
 		{
-			// SComponentsێĂChunkȂmF
-			for(const auto& chunk : chunks_ | std::views::values)
-			{
-				if(chunk->IsSame<Components...>()) return chunk;
-			}
+			if(++*change_version_ == 0) ++*change_version_;
+			return *change_version_;
+		}
 
-			const ChunkPtr chunk = std::make_shared<Chunk>(Chunk::Create<Components...>(100));
-			chunks_[chunk->GetArchetype().GetArchetypeId()] = chunk;
-			return chunk;
+		// gp̂
+		// SComponentsƋLComponent̒lێĂArchetypeStorageꍇ͂ԂAȂꍇ͐Vɍ쐬
+		// shared_values CreateSharedComponentValuesō쐬LComponent̒l
+		template<class ...Components>
+		ArchetypeStorage* GetOrAddArchetypeStorage(std::span<const SharedComponentValue> shared_values)
+		{
+			const auto it{ archetype_storages_.find(StorageKey{ Archetype::CreateArchetypeId<Components...>(), Archetype::GetSortedComponentIds<Components...>(), shared_values }) };
+			if(it != archetype_storages_.end()) return it->second.get();
+			return AddArchetypeStorage(Archetype::Create<Components...>(), { shared_values.begin(), shared_values.end() }).get();
 		}
 
-		// SComponentsێĂChunk擾
-		// ȂꍇnullptrԂ
+		// gp̂
+		// ComponentŝLComponent̒lo^AComponentId̏ɕׂ LComponentȂꍇ͋
+		// values eComponent̒l nullptȑꍇ͊l
 		template<class ...Components>
-		ChunkPtr GetSameChunk()
+		Vector<SharedComponentValue> CreateSharedComponentValues(const Components*... values)
 		{
-			for(auto it = chunks_.begin(); it != chunks_.end(); ++it)
+			Vector<SharedComponentValue> ret{};
+			if constexpr((SharedComponent<Components> || ...))
 			{
-				if(it->second->IsSame<Components...>()) return it->second;
+				([this, &ret](const auto* value)
+				{
+					using Component = std::remove_cvref_t<decltype(*value)>;
+					if constexpr(SharedComponent<Component>) ret.emplace_back(shared_components_.Add(value ? *value : Component{}));
+				}(values), ...);
+				std::ranges::sort(ret, {}, &SharedComponentValue::id_);
 			}
-			return nullptr;
+			return ret;
+		}
+
+		// gp̂
+		// ArchetypeStorage쐬ēo^ASĂQueryɒʒm
+		// archetype o^ĂȂArchetype
+		// shared_values Archetype̋LComponent̒l ComponentId̏
+		ArchetypeStoragePtr AddArchetypeStorage(Archetype archetype, Vector<SharedComponentValue> shared_values);
+
+		// gp̂
+		// AddEntities̎
+		// shared_values CreateSharedComponentValuesō쐬LComponent̒l
+		// func i[ChunkƂɌĂ΂ void(Chunk& chunk, u32 index, u32 counts) i[sComponent\z
+		template<class ...Components, class Func>
+		void AddEntitiesImpl(u32 counts, std::span<Entity> out, std::span<const SharedComponentValue> shared_values, Func&& func)
+		{
+			_ASSERT_EXPR(out.size() >= counts, L"out̑傫܂");
+
+			const std::span<Entity> entities{ out.first(counts) };
+			entity_manager_.CreateEntities(entities);
+
+			ArchetypeStorage* storage{ GetOrAddArchetypeStorage<Components...>(shared_values) };
+			storage->AddEntities(entities, entity_manager_, func);
 		}
 
+		// gp̂
+		// VOl`ƋLComponent̒lvArchetypeStorage擾AȂꍇ͐Vɍ쐬
+		// component_ids ɕ񂾏d̂ȂComponentId
+		// shared_values component_ids̋LComponent̒l ComponentId̏
+		ArchetypeStorage* GetOrAddArchetypeStorage(std::span<const ComponentId> component_ids, std::span<const SharedComponentValue> shared_values);
+
+		// gp̂
+		// srcArchetypeidArchetypeStorage擾
+		// xHgݍ킹ArchetypeStorageɃLbV̂2ڈȍ~̓VOl`̌sȂ
+		ArchetypeStorage* GetAddComponentArchetypeStorage(ArchetypeStorage& src, ComponentId id);
+
+		// gp̂
+		// srcArchetypeidArchetypeStorage擾
+		// xHgݍ킹ArchetypeStorageɃLbV̂2ڈȍ~̓VOl`̌sȂ
+		ArchetypeStorage* GetRemoveComponentArchetypeStorage(ArchetypeStorage& src, ComponentId id);
+
+		// gp̂
+		// srcArchetypeidsshared_valuesArchetypeStorage擾 AddComponentsŎgp
+		// gݍ킹̂ŃLbVȂ
+		// ids ǉComponentId LComponent܂
+		// shared_values ǉ鋤LComponent̒l Ԃ͖Ȃ
+		ArchetypeStorage* GetAddComponentsArchetypeStorage(ArchetypeStorage& src, std::span<const ComponentId> ids, std::span<const SharedComponentValue> shared_values);
+
+		// gp̂
+		// srcArchetypeidsArchetypeStorage擾 RemoveComponentsŎgp
+		// gݍ킹̂ŃLbVȂ
+		ArchetypeStorage* GetRemoveComponentsArchetypeStorage(ArchetypeStorage& src, std::span<const ComponentId> ids);
+
+		// gp̂
+		// src̋LComponent̒lshared_valueɒu(ێĂȂꍇ͒ǉ)ArchetypeStorage擾
+		// lɂĈړ悪ς̂ŃLbVȂ
+		ArchetypeStorage* GetSharedComponentArchetypeStorage(ArchetypeStorage& src, const SharedComponentValue& shared_value);
+
+		// gp̂
+		// LComponent̒l̑gvĂ邩
+		static bool IsSameSharedComponentValues(std::span<const SharedComponentValue> lhs, std::span<const SharedComponentValue> rhs);
+
+		// gp̂
+		// 쐬Queryɓo^ς݂ArchetypeStorageSĒʒm
+		void InitializeQuery(QueryBase& query) const;
+
 	private:
 
+		// archetype_storages_̃L[ VOl`ƋLComponent̒l̑gvĂ邩Ŕr
+		// o^L[ArchetypeStorageێĂVOl`ƒlQƂ
+		struct StorageKey
+		{
+			ArchetypeId archetype_id_;	// nbV̌vZɂ̂ݎgp
+			std::span<const ComponentId> component_ids_;	// ɕ񂾏d̂ȂComponentId
+			std::span<const SharedComponentValue> shared_values_;	// ComponentId̏
+
+			bool operator==(const StorageKey& other) const
+			{
+				return std::ranges::equal(component_ids_, other.component_ids_) && IsSameSharedComponentValues(shared_values_, other.shared_values_);
+			}
+		};
+
+		// ArchetypeIdɋLComponent̒l̔ԍnbV LComponentȂꍇArchetypeId̂
+		struct StorageKeyHash
+		{
+			u64 operator()(const StorageKey& key) const;
+		};
+
+		// Chunk܂ŎcĂKv̂archetype_storages_ɐ錾
+		UniquePtr<ChunkPool> chunk_pool_{};	// chunk_memory_resourcew肳ȂꍇɎgp
+		std::pmr::memory_resource* chunk_memory_resource_{};
+		Vector<UniquePtr<MappedSnapshot>> snapshots_{};	// LoadŃ}bvt@C Chunk̈̂܂܎gpĂ
+		SharedComponentStore shared_components_{};	// LComponent̒l ChunkQƂ
+		UniquePtr<u32> change_version_{ std::make_unique<u32>(1) };	// ChunkQƂ̂WorldړĂAhXςȂ悤Ƀq[vɒu
+
 		EntityManager entity_manager_{};
-		UnorderedMap<Entity, ArchetypeId> entity_archetype_map_{};
-		UnorderedMap<ArchetypeId, ChunkPtr> chunks_{};
+		UnorderedMap<StorageKey, ArchetypeStoragePtr, StorageKeyHash> archetype_storages_{};
+		Vector<UniquePtr<QueryBase>> queries_{};	// TypeIndexRegistry<QueryBase>IDIndexƂQuery
+		UniquePtr<std::mutex> query_mutex_{ std::make_unique<std::mutex>() };	// GetQueryŎgp Worldړł悤Ƀq[vɒu
+		Vector<UniquePtr<EntityCommandBuffer>> entity_command_buffers_{};	// GetEntityCommandBufferŃXbhƂɍ쐬obt@
+		u64 serial_number_{};	// XbhƂ̃obt@WorldƂɋʂ邽߂̔ԍ AhXƈႢėpȂ
 		UniquePtr<SystemManager> system_manager_{};
+		UniquePtr<JobSystem> job_system_{};
+#if ECS_PROFILER_ENABLED
+		UniquePtr<SystemProfiler> profiler_{};	// ECS_PROFILER_ENABLED0̏ꍇ͕ێȂ
+#endif
 	};
 
 	
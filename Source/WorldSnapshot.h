@@ -0,0 +1,195 @@
+#pragma once
+
+#include "CommonHeader.h"
+#include "ECSCommon.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ecs
+{
+	// World::Saveŕۑt@Č`
+	// [SnapshotHeader][^f[^] ... [Chunk::GetBuffer̃f[^] ...
+	// ^f[^Component̕\ALComponent̒lAEntity̕\AArchetypeStorage̕\̏ɕ
+	// Chunk̃f[^͂ꂼy[WEɑĊi[̂ŁA}bvt@Ĉ܂Chunk̗̈ƂĎgpł
+	struct SnapshotHeader
+	{
+		static constexpr std::array<char, 8> kMagic{ 'E', 'C', 'S', 'S', 'N', 'A', 'P', '\0' };
+		static constexpr u32 kVersion{ 1 };
+
+		// Chunk̃f[^̐擪̃ACg(oCg)
+		static constexpr u64 kPageSize{ 4096 };
+
+		std::array<char, 8> magic_;
+		u32 version_;
+		u32 chunk_size_;	// ۑƂChunk::kChunkSize
+		u64 metadata_size_;	// SnapshotHeader̒ɑ^f[^̃TCY
+		u64 blob_offset_;	// ŏChunk̃f[^̃t@C擪̃ItZbg kPageSize̔{
+	};
+
+	// ^f[^oCgɏ
+	class SnapshotWriter
+	{
+	public:
+		template<class T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void WriteBytes(const void* data, u64 size)
+		{
+			const u8* begin{ static_cast<const u8*>(data) };
+			data_.insert(data_.end(), begin, begin + size);
+		}
+
+		void WriteString(std::string_view str)
+		{
+			Write(static_cast<u32>(str.size()));
+			WriteBytes(str.data(), str.size());
+		}
+
+		std::span<const u8> GetData() const { return data_; }
+
+	private:
+		Vector<u8> data_{};
+	};
+
+	// ^f[^oCg񂩂ǂݍ
+	// ͈͊OǂݍƂꍇ͎sƂL^Aȍ~͑SĊlԂ
+	class SnapshotReader
+	{
+	public:
+		explicit SnapshotReader(std::span<const u8> data) : data_(data) {}
+
+		template<class T>
+		T Read()
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			T ret{};
+			const std::span<const u8> bytes{ ReadBytes(sizeof(T)) };
+			if(!bytes.empty()) std::memcpy(&ret, bytes.data(), sizeof(T));
+			return ret;
+		}
+
+		// ߂l ͈͊Ȍꍇ͋
+		std::span<const u8> ReadBytes(u64 size)
+		{
+			if(is_failed_ || size > data_.size() - offset_)
+			{
+				is_failed_ = true;
+				return {};
+			}
+			const std::span<const u8> ret{ data_.subspan(offset_, size) };
+			offset_ += size;
+			return ret;
+		}
+
+		// vf̐ǂݍ c̃oCg葽ꍇ͉Ă̂Ŏs
+		u32 ReadCounts()
+		{
+			const u32 counts{ Read<u32>() };
+			if(counts > data_.size() - offset_) is_failed_ = true;
+			return is_failed_ ? 0 : counts;
+		}
+
+		std::string_view ReadString()
+		{
+			const std::span<const u8> bytes{ ReadBytes(ReadCounts()) };
+			return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+		}
+
+		bool IsFailed() const { return is_failed_; }
+
+	private:
+		std::span<const u8> data_;
+		u64 offset_{};
+		bool is_failed_{};
+	};
+
+	// World::Loadœǂݍރt@CɃ}bv
+	// }bv̓Rs[ICgȂ̂ŁAChunkɏłt@C͕ύXȂ
+	// Chunk̓}bv̈̂܂܎gp̂ŁAWorldj܂ŕێ
+	// Chunk̔jɉC郁\[XƂĂgpA}bv̈̓}bvƂɂ܂Ƃ߂ĉ
+	class MappedSnapshot : public std::pmr::memory_resource
+	{
+	public:
+		// }bvɎsꍇGetDataɂȂ
+		explicit MappedSnapshot(const std::filesystem::path& path)
+		{
+#ifdef _WIN32
+			const HANDLE file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+			if(file == INVALID_HANDLE_VALUE) return;
+
+			LARGE_INTEGER size{};
+			if(GetFileSizeEx(file, &size) && size.QuadPart > 0)
+			{
+				if(const HANDLE mapping{ CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) })
+				{
+					data_ = static_cast<u8*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+					if(data_) size_ = static_cast<u64>(size.QuadPart);
+					CloseHandle(mapping);
+				}
+			}
+			CloseHandle(file);
+#else
+			const int file{ open(path.c_str(), O_RDONLY) };
+			if(file < 0) return;
+
+			struct stat status{};
+			if(fstat(file, &status) == 0 && status.st_size > 0)
+			{
+				void* data{ mmap(nullptr, static_cast<u64>(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0) };
+				if(data != MAP_FAILED)
+				{
+					data_ = static_cast<u8*>(data);
+					size_ = static_cast<u64>(status.st_size);
+				}
+			}
+			close(file);
+#endif
+		}
+
+		~MappedSnapshot() override
+		{
+			if(!data_) return;
+#ifdef _WIN32
+			UnmapViewOfFile(data_);
+#else
+			munmap(data_, size_);
+#endif
+		}
+
+		MappedSnapshot(const MappedSnapshot&) = delete;
+		MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+		MappedSnapshot(MappedSnapshot&&) = delete;
+		MappedSnapshot& operator=(MappedSnapshot&&) = delete;
+
+		std::span<u8> GetData() const { return { data_, size_ }; }
+
+	private:
+
+		void* do_allocate(std::size_t, std::size_t) override
+		{
+			_ASSERT_EXPR(FALSE, L"MappedSnapshot͊mۂł܂");
+			return nullptr;
+		}
+
+		// }bv܂ŗ̈͗LȂ̂ŉȂ
+		void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+
+	private:
+		u8* data_{};
+		u64 size_{};
+	};
+}